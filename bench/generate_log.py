@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#
+#     This file is part of valgrind_log_tool
+#     Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+#
+#     This program is free software: you can redistribute it and/or modify
+#     it under the terms of the GNU General Public License as published by
+#     the Free Software Foundation, either version 3 of the License, or
+#     (at your option) any later version.
+#
+#     This program is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#     GNU General Public License for more details.
+#
+#     You should have received a copy of the GNU General Public License
+#     along with this program.  If not, see <http://www.gnu.org/licenses/>
+#
+"""Write a synthetic valgrind memcheck XML log on standard output.
+
+The log is deterministic for a given seed so that benchmarks of several
+builds parse the same document.
+"""
+
+import argparse
+import random
+import sys
+
+OBJECTS = ["/usr/lib/libc.so.6", "/usr/bin/program", "/usr/lib/libstdc++.so.6", "/usr/lib/valgrind/vgpreload_memcheck-amd64-linux.so"]
+FUNCTIONS = ["main", "malloc", "operator new(unsigned long)", "std::vector&lt;int, std::allocator&lt;int&gt; &gt;::push_back(int const&amp;)", "parse", "render", "update"]
+DIRECTORIES = ["/home/user/program/src", "/home/user/program/include", "/usr/include/c++"]
+FILES = ["main.cpp", "parser.cpp", "renderer.cpp", "vector.h", "vector.tcc"]
+KINDS = ["InvalidRead", "InvalidWrite", "UninitCondition", "Leak_DefinitelyLost", "Leak_PossiblyLost"]
+
+
+def main():
+    l_parser = argparse.ArgumentParser(description=__doc__)
+    l_parser.add_argument("--errors", type=int, default=10000, help="number of errors")
+    l_parser.add_argument("--frames", type=int, default=4096, help="number of distinct instruction pointers")
+    l_parser.add_argument("--depth", type=int, default=12, help="maximum number of frames per stack")
+    l_parser.add_argument("--seed", type=int, default=1, help="random seed")
+    l_parser.add_argument("--pid", type=int, default=1234, help="pid of valgrind process")
+    l_args = l_parser.parse_args()
+
+    l_random = random.Random(l_args.seed)
+    l_frames = []
+    for l_index in range(l_args.frames):
+        l_frames.append((0x400000 + 16 * l_index,
+                         l_random.choice(OBJECTS),
+                         l_random.choice(FUNCTIONS + [None]),
+                         l_random.choice(DIRECTORIES),
+                         l_random.choice(FILES + [None]),
+                         l_random.randint(1, 2000)))
+
+    l_out = sys.stdout
+    l_out.write('<?xml version="1.0"?>\n\n<valgrindoutput>\n\n')
+    l_out.write('<protocolversion>4</protocolversion>\n<protocoltool>memcheck</protocoltool>\n\n')
+    l_out.write('<preamble>\n  <line>Memcheck, a memory error detector</line>\n</preamble>\n\n')
+    l_out.write('<pid>%d</pid>\n<ppid>1</ppid>\n<tool>memcheck</tool>\n\n' % l_args.pid)
+    l_out.write('<args>\n  <vargv>\n    <exe>/usr/bin/valgrind</exe>\n  </vargv>\n  <argv>\n    <exe>/usr/bin/program</exe>\n  </argv>\n</args>\n\n')
+    l_out.write('<status>\n  <state>RUNNING</state>\n  <time>00:00:00:00.050 </time>\n</status>\n\n')
+
+    # Stacks are drawn among a limited set so that some of them repeat
+    l_stacks = []
+    for l_index in range(max(1, l_args.errors // 4)):
+        l_depth = l_random.randint(1, l_args.depth)
+        l_stacks.append([l_random.randrange(l_args.frames) for l_rank in range(l_depth)])
+
+    for l_index in range(l_args.errors):
+        l_kind = l_random.choice(KINDS)
+        l_out.write('<error>\n  <unique>0x%x</unique>\n  <tid>1</tid>\n  <kind>%s</kind>\n' % (l_index + 1, l_kind))
+        if l_kind.startswith("Leak"):
+            l_bytes = l_random.randint(1, 1 << 20)
+            l_out.write('  <xwhat>\n    <text>%d bytes in 1 blocks are definitely lost in loss record %d of %d</text>\n'
+                        '    <leakedbytes>%d</leakedbytes>\n    <leakedblocks>1</leakedblocks>\n  </xwhat>\n'
+                        % (l_bytes, l_index + 1, l_args.errors, l_bytes))
+        else:
+            l_out.write('  <what>Invalid read of size %d</what>\n' % l_random.choice([1, 2, 4, 8]))
+        l_out.write('  <stack>\n')
+        for l_frame_index in l_random.choice(l_stacks):
+            l_ip, l_obj, l_fn, l_dir, l_file, l_line = l_frames[l_frame_index]
+            l_out.write('    <frame>\n      <ip>0x%X</ip>\n      <obj>%s</obj>\n' % (l_ip, l_obj))
+            if l_fn:
+                l_out.write('      <fn>%s</fn>\n' % l_fn)
+            if l_file:
+                l_out.write('      <dir>%s</dir>\n      <file>%s</file>\n      <line>%d</line>\n' % (l_dir, l_file, l_line))
+            l_out.write('    </frame>\n')
+        l_out.write('  </stack>\n</error>\n\n')
+
+    l_out.write('<errorcounts>\n')
+    for l_index in range(0, l_args.errors, 2):
+        l_out.write('  <pair>\n    <count>%d</count>\n    <unique>0x%x</unique>\n  </pair>\n' % (l_random.randint(1, 100), l_index + 1))
+    l_out.write('</errorcounts>\n\n<suppcounts>\n</suppcounts>\n\n</valgrindoutput>\n\n')
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,106 @@
+#!/bin/bash
+#
+#     This file is part of valgrind_log_tool
+#     Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+#
+#     This program is free software: you can redistribute it and/or modify
+#     it under the terms of the GNU General Public License as published by
+#     the Free Software Foundation, either version 3 of the License, or
+#     (at your option) any later version.
+#
+#     This program is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#     GNU General Public License for more details.
+#
+#     You should have received a copy of the GNU General Public License
+#     along with this program.  If not, see <http://www.gnu.org/licenses/>
+#
+# Compare valgrind_log_tool builds on generated logs. Each binary given
+# is run on the same logs and the best time of several runs, as displayed
+# by --stats, is kept for each scenario.
+#
+# Usage: run_benchmarks.sh [-e errors] [-r runs] binary...
+
+set -e
+
+ERRORS=30000
+RUNS=5
+while getopts "e:r:" OPTION
+do
+    case $OPTION in
+        e) ERRORS=$OPTARG ;;
+        r) RUNS=$OPTARG ;;
+        *) echo "Usage: $0 [-e errors] [-r runs] binary..." >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+if [ $# -eq 0 ]
+then
+    echo "Usage: $0 [-e errors] [-r runs] binary..." >&2
+    exit 1
+fi
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+python3 "$BENCH_DIR/generate_log.py" --errors "$ERRORS" > "$WORK_DIR/log.xml"
+echo "Log: $ERRORS errors, $(du -h "$WORK_DIR/log.xml" | cut -f1)"
+# Deep stacks of distinct frames where ip and line fields dominate
+python3 "$BENCH_DIR/generate_log.py" --errors $((ERRORS / 4)) --frames 65536 --depth 64 > "$WORK_DIR/deep.xml"
+echo "Deep stack log: $((ERRORS / 4)) errors, $(du -h "$WORK_DIR/deep.xml" | cut -f1)"
+
+# Run a binary several times and display the smallest value extracted
+# from its --stats output
+# $1: binary
+# $2: sed expression printing the measured value
+# $3...: options and logs
+measure()
+{
+    local BINARY=$1
+    local EXPRESSION=$2
+    shift 2
+    local BEST=""
+    for RUN in $(seq "$RUNS")
+    do
+        local VALUE
+        VALUE=$(cd "$WORK_DIR" && "$BINARY" --stats "$@" | sed -n "$EXPRESSION")
+        if [ -z "$VALUE" ]
+        then
+            echo "n/a"
+            return
+        fi
+        if [ -z "$BEST" ] || awk "BEGIN {exit !($VALUE < $BEST)}"
+        then
+            BEST=$VALUE
+        fi
+    done
+    echo "$BEST"
+}
+
+PARSING='s/^Parsing:.*(\([0-9.e+]*\) ns per node)/\1/p'
+AGGREGATION='s/^Report: aggregation with [0-9]* thread(s) in \([0-9.e+]*\) ms.*/\1/p'
+GENERATION='s/^Report: .* generation in \([0-9.e+]*\) ms.*/\1/p'
+JOBS=$(nproc)
+
+# Tag identification of the source tree against the std::map lookup it
+# replaced, independently of the binaries compared
+${CXX:-c++} -std=c++11 -O3 -DNDEBUG -I"$BENCH_DIR/../include" "$BENCH_DIR/tag_dispatch.cpp" -o "$WORK_DIR/tag_dispatch"
+"$WORK_DIR/tag_dispatch" "$WORK_DIR/log.xml" "$RUNS"
+
+for BINARY in "$@"
+do
+    BINARY=$(cd "$(dirname "$BINARY")" && pwd)/$(basename "$BINARY")
+    echo "== $BINARY"
+    # Tag dispatch, element stack and number parsing are measured per node
+    echo "parsing mapped: $(measure "$BINARY" "$PARSING" log.xml) ns per node"
+    echo "parsing stream: $(measure "$BINARY" "$PARSING" --stream log.xml) ns per node"
+    echo "parsing dom: $(measure "$BINARY" "$PARSING" --dom log.xml) ns per node"
+    echo "parsing numeric fields: $(measure "$BINARY" "$PARSING" deep.xml) ns per node"
+    # Aggregation only uses several threads above 64K stack entries per thread
+    echo "aggregation 1 thread: $(measure "$BINARY" "$AGGREGATION" --jobs 1 log.xml) ms"
+    echo "aggregation $JOBS threads: $(measure "$BINARY" "$AGGREGATION" --jobs "$JOBS" log.xml) ms"
+    # Anchors, links and frame rows of valgrind.html written by one thread
+    echo "html generation: $(measure "$BINARY" "$GENERATION" --jobs 1 log.xml) ms"
+done
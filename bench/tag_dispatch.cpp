@@ -0,0 +1,137 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+// Compare identification of element names with get_valgrind_tag against
+// the std::map<std::string, ...> lookup it replaced, on the opening tags of
+// a log so that tags are as frequent as in real logs.
+//
+// Usage: tag_dispatch <valgrind XML log> [repetitions]
+
+#include "valgrind_tag.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+
+/**
+ * Receives lookup results so that lookups cannot be optimised out
+ */
+static volatile unsigned int g_sink = 0;
+
+/**
+ * Run lookups on all names and keep best time of repetitions
+ * @param p_names names to identify
+ * @param p_repetitions number of runs
+ * @param p_lookup function identifying a name
+ * @return best time per name in nanoseconds
+ */
+template <typename LOOKUP>
+static double measure( const std::vector<valgrind_log_tool::string_ref> & p_names
+                     , unsigned int p_repetitions
+                     , LOOKUP p_lookup
+                     )
+{
+    double l_best = 0;
+    unsigned int l_check = 0;
+    for(unsigned int l_repetition = 0; l_repetition < p_repetitions; ++l_repetition)
+    {
+        auto l_start = std::chrono::steady_clock::now();
+        for(const auto & l_name: p_names)
+        {
+            l_check += static_cast<unsigned int>(p_lookup(l_name));
+        }
+        std::chrono::duration<double> l_duration = std::chrono::steady_clock::now() - l_start;
+        double l_time = l_duration.count() * 1e9 / p_names.size();
+        if(!l_repetition || l_time < l_best)
+        {
+            l_best = l_time;
+        }
+    }
+    g_sink = l_check;
+    return l_best;
+}
+
+int main(int p_argc, char ** p_argv)
+{
+    if(p_argc < 2 || p_argc > 3)
+    {
+        std::cerr << "Usage: tag_dispatch <valgrind XML log> [repetitions]" << std::endl;
+        return 1;
+    }
+    std::ifstream l_file(p_argv[1]);
+    if(!l_file)
+    {
+        std::cerr << "Unable to open file \"" << p_argv[1] << "\"" << std::endl;
+        return 1;
+    }
+    std::string l_content{std::istreambuf_iterator<char>(l_file), std::istreambuf_iterator<char>()};
+    unsigned int l_repetitions = 3 == p_argc ? static_cast<unsigned int>(std::strtoul(p_argv[2], nullptr, 10)) : 5;
+    if(!l_repetitions)
+    {
+        std::cerr << "Number of repetitions should be at least 1" << std::endl;
+        return 1;
+    }
+
+    // Names of opening tags, referencing log content like the parser does
+    std::vector<valgrind_log_tool::string_ref> l_names;
+    for(size_t l_index = l_content.find('<'); std::string::npos != l_index; l_index = l_content.find('<', l_index + 1))
+    {
+        size_t l_end = l_index + 1;
+        while(l_end < l_content.size() && (isalnum(static_cast<unsigned char>(l_content[l_end])) || '_' == l_content[l_end]))
+        {
+            ++l_end;
+        }
+        if(l_end > l_index + 1)
+        {
+            l_names.emplace_back(l_content.data() + l_index + 1, l_end - l_index - 1);
+        }
+    }
+    if(l_names.empty())
+    {
+        std::cerr << "No element in file \"" << p_argv[1] << "\"" << std::endl;
+        return 1;
+    }
+
+    // Map lookup as done before tags were identified by switches
+    std::map<std::string, valgrind_log_tool::valgrind_tag> l_tags;
+    for(unsigned int l_index = 0; l_index < valgrind_log_tool::valgrind_tag_number; ++l_index)
+    {
+        valgrind_log_tool::valgrind_tag l_tag = static_cast<valgrind_log_tool::valgrind_tag>(l_index);
+        l_tags.insert(std::make_pair(std::string(valgrind_log_tool::get_valgrind_tag_name(l_tag)), l_tag));
+    }
+
+    double l_map_time = measure(l_names, l_repetitions, [&](const valgrind_log_tool::string_ref & p_name)
+                                {
+                                    auto l_iter = l_tags.find(p_name.str());
+                                    return l_tags.end() != l_iter ? l_iter->second : valgrind_log_tool::valgrind_tag::unknown;
+                                }
+                               );
+    double l_switch_time = measure(l_names, l_repetitions, [](const valgrind_log_tool::string_ref & p_name)
+                                   {
+                                       return valgrind_log_tool::get_valgrind_tag(p_name);
+                                   }
+                                  );
+    std::cout << "Tag dispatch: " << l_names.size() << " names, std::map " << l_map_time << " ns per name, get_valgrind_tag " << l_switch_time << " ns per name" << std::endl;
+    return 0;
+}
+// EOF
@@ -0,0 +1,310 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_COMPRESSED_STREAMBUF_H
+#define VALGRIND_LOG_TOOL_COMPRESSED_STREAMBUF_H
+
+#include "quicky_exception.h"
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <sys/stat.h>
+#include <zlib.h>
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+#include <zstd.h>
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream buffer decompressing a gzip or zstd file while it is read so
+     * that decompressed data never needs to be stored. zstd support
+     * requires VALGRIND_LOG_TOOL_USE_ZSTD to be defined
+     */
+    class compressed_streambuf: public std::streambuf
+    {
+      public:
+
+        enum class t_format
+        { none
+        , gzip
+        , zstd
+        };
+
+        /**
+         * Detect compression format from magic number at file beginning.
+         * Only regular files are read: bytes read from a pipe would be lost
+         * for the parsing that follows
+         * @param p_file_name name of file
+         * @return compression format, none if file is not compressed, is
+         * not a regular file or cannot be read
+         */
+        inline static
+        t_format get_format(const std::string & p_file_name);
+
+        /**
+         * @param p_file_name compressed file
+         * @param p_format compression format, different from none
+         */
+        inline
+        compressed_streambuf( const std::string & p_file_name
+                            , t_format p_format
+                            );
+
+        compressed_streambuf(const compressed_streambuf &) = delete;
+
+        compressed_streambuf & operator=(const compressed_streambuf &) = delete;
+
+        inline
+        ~compressed_streambuf() override;
+
+      protected:
+
+        inline
+        int_type underflow() override;
+
+      private:
+
+        /**
+         * Read compressed data once previous one has been decompressed
+         * @return false if end of file is reached
+         */
+        inline
+        bool read_input();
+
+        /**
+         * Decompress available compressed data in output buffer
+         * @return number of decompressed bytes
+         */
+        inline
+        size_t decompress_gzip();
+
+        inline
+        size_t decompress_zstd();
+
+        [[noreturn]] inline
+        void throw_error(const std::string & p_message) const;
+
+        std::string m_file_name;
+        std::ifstream m_file;
+        t_format m_format;
+
+        std::vector<char> m_input;
+
+        /**
+         * Part of input buffer not yet decompressed
+         */
+        size_t m_input_begin;
+        size_t m_input_end;
+
+        std::vector<char> m_output;
+
+        /**
+         * Set when last gzip member or zstd frame is complete so that a
+         * truncated file can be detected
+         */
+        bool m_complete;
+
+        z_stream m_zlib;
+
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+        ZSTD_DStream * m_zstd;
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+
+        static const size_t m_buffer_size = 1 << 16;
+    };
+
+    //-------------------------------------------------------------------------
+    compressed_streambuf::t_format
+    compressed_streambuf::get_format(const std::string & p_file_name)
+    {
+        struct stat l_stat;
+        if(stat(p_file_name.c_str(), &l_stat) || !S_ISREG(l_stat.st_mode))
+        {
+            return t_format::none;
+        }
+        std::ifstream l_file(p_file_name, std::ios::in | std::ios::binary);
+        unsigned char l_magic[4] = {0, 0, 0, 0};
+        l_file.read(reinterpret_cast<char *>(l_magic), sizeof(l_magic));
+        if(0x1F == l_magic[0] && 0x8B == l_magic[1])
+        {
+            return t_format::gzip;
+        }
+        if(0x28 == l_magic[0] && 0xB5 == l_magic[1] && 0x2F == l_magic[2] && 0xFD == l_magic[3])
+        {
+            return t_format::zstd;
+        }
+        return t_format::none;
+    }
+
+    //-------------------------------------------------------------------------
+    compressed_streambuf::compressed_streambuf( const std::string & p_file_name
+                                              , t_format p_format
+                                              )
+    : m_file_name(p_file_name)
+    , m_file(p_file_name, std::ios::in | std::ios::binary)
+    , m_format(p_format)
+    , m_input(m_buffer_size)
+    , m_input_begin(0)
+    , m_input_end(0)
+    , m_output(m_buffer_size)
+    , m_complete(false)
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+    , m_zstd(nullptr)
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+    {
+        if(!m_file.is_open())
+        {
+            throw quicky_exception::quicky_runtime_exception("File \"" + p_file_name + "\" not found", __LINE__, __FILE__);
+        }
+        memset(&m_zlib, 0, sizeof(m_zlib));
+        switch(p_format)
+        {
+            case t_format::gzip:
+                // 16 added to window size to only accept gzip format
+                if(Z_OK != inflateInit2(&m_zlib, 15 + 16))
+                {
+                    throw_error("Unable to initialise zlib");
+                }
+                break;
+            case t_format::zstd:
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+                m_zstd = ZSTD_createDStream();
+                if(!m_zstd || ZSTD_isError(ZSTD_initDStream(m_zstd)))
+                {
+                    ZSTD_freeDStream(m_zstd);
+                    throw_error("Unable to initialise zstd");
+                }
+                break;
+#else // VALGRIND_LOG_TOOL_USE_ZSTD
+                throw_error("zstd support is not enabled");
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+            case t_format::none:
+                throw_error("File is not compressed");
+        }
+        setg(m_output.data(), m_output.data(), m_output.data());
+    }
+
+    //-------------------------------------------------------------------------
+    compressed_streambuf::~compressed_streambuf()
+    {
+        if(t_format::gzip == m_format)
+        {
+            inflateEnd(&m_zlib);
+        }
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+        ZSTD_freeDStream(m_zstd);
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+    }
+
+    //-------------------------------------------------------------------------
+    compressed_streambuf::int_type
+    compressed_streambuf::underflow()
+    {
+        if(gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+        for(;;)
+        {
+            if(m_input_begin == m_input_end && !read_input())
+            {
+                if(!m_complete)
+                {
+                    throw_error("Unexpected end of compressed data");
+                }
+                return traits_type::eof();
+            }
+            size_t l_size = t_format::gzip == m_format ? decompress_gzip() : decompress_zstd();
+            if(l_size)
+            {
+                setg(m_output.data(), m_output.data(), m_output.data() + l_size);
+                return traits_type::to_int_type(*gptr());
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    compressed_streambuf::read_input()
+    {
+        m_input_begin = 0;
+        m_input_end = m_file.rdbuf()->sgetn(m_input.data(), m_input.size());
+        return m_input_end;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    compressed_streambuf::decompress_gzip()
+    {
+        // Concatenated gzip members are decompressed one after the other
+        if(m_complete)
+        {
+            inflateReset(&m_zlib);
+            m_complete = false;
+        }
+        m_zlib.next_in = reinterpret_cast<Bytef *>(m_input.data() + m_input_begin);
+        m_zlib.avail_in = static_cast<uInt>(m_input_end - m_input_begin);
+        m_zlib.next_out = reinterpret_cast<Bytef *>(m_output.data());
+        m_zlib.avail_out = static_cast<uInt>(m_output.size());
+        int l_result = inflate(&m_zlib, Z_NO_FLUSH);
+        if(Z_STREAM_END == l_result)
+        {
+            m_complete = true;
+        }
+        else if(Z_OK != l_result && Z_BUF_ERROR != l_result)
+        {
+            throw_error(std::string("Invalid gzip data: ") + (m_zlib.msg ? m_zlib.msg : zError(l_result)));
+        }
+        m_input_begin = m_input_end - m_zlib.avail_in;
+        return m_output.size() - m_zlib.avail_out;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    compressed_streambuf::decompress_zstd()
+    {
+#ifdef VALGRIND_LOG_TOOL_USE_ZSTD
+        ZSTD_inBuffer l_input{m_input.data() + m_input_begin, m_input_end - m_input_begin, 0};
+        ZSTD_outBuffer l_output{m_output.data(), m_output.size(), 0};
+        size_t l_result = ZSTD_decompressStream(m_zstd, &l_output, &l_input);
+        if(ZSTD_isError(l_result))
+        {
+            throw_error(std::string("Invalid zstd data: ") + ZSTD_getErrorName(l_result));
+        }
+        // 0 is returned once a frame is completely decoded and flushed
+        m_complete = !l_result;
+        m_input_begin += l_input.pos;
+        return l_output.pos;
+#else // VALGRIND_LOG_TOOL_USE_ZSTD
+        throw_error("zstd support is not enabled");
+#endif // VALGRIND_LOG_TOOL_USE_ZSTD
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    compressed_streambuf::throw_error(const std::string & p_message) const
+    {
+        throw quicky_exception::quicky_logic_exception("\"" + p_message + "\" in file \"" + m_file_name + "\"", __LINE__, __FILE__);
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_COMPRESSED_STREAMBUF_H
+// EOF
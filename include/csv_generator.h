@@ -0,0 +1,167 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_CSV_GENERATOR_H
+#define VALGRIND_LOG_TOOL_CSV_GENERATOR_H
+
+#include "report_generator.h"
+#include "report_file.h"
+#include "string_ref.h"
+#include <ostream>
+#include <string>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Write one CSV line per error with the innermost frame of its call
+     * stack, to be loaded in spreadsheets or dashboards
+     */
+    class csv_generator: public report_generator
+    {
+      public:
+
+        /**
+         * @param p_output_file_name name of report file
+         * @param p_jobs number of threads compressing report
+         * @param p_compressed true to write report compressed with gzip
+         */
+        inline explicit
+        csv_generator( const std::string & p_output_file_name
+                     , unsigned int p_jobs = 1
+                     , bool p_compressed = false
+                     );
+
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
+        inline
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) override;
+
+      private:
+
+        /**
+         * Write a field, quoted when it contains a separator, a quote or
+         * a line break
+         */
+        inline
+        void write_field(const string_ref & p_field);
+
+        report_file m_file;
+    };
+
+    //-------------------------------------------------------------------------
+    csv_generator::csv_generator( const std::string & p_output_file_name
+                                , unsigned int p_jobs
+                                , bool p_compressed
+                                )
+    : m_file(p_output_file_name, p_compressed, p_jobs)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    csv_generator::generate( const valgrind_log_content & p_content
+                           , const valgrind_log_statistics & p_statistics
+                           )
+    {
+        // "stack" is the index of the first error having the same call stack
+        m_file << "index,log_file,pid,unique,tid,kind,what,aux_what,xwhat,leaked_bytes,leaked_blocks,stack_size,stack,ip,object,function,directory,file,line\n";
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+        for(size_t l_index = 0; l_index < l_errors.get_size(); ++l_index)
+        {
+            const valgrind_error l_error = l_errors.get(l_index);
+            m_file << l_index << ',';
+            write_field(l_error.get_source().get_name());
+            m_file << ',' << l_error.get_source().get_pid() << ',' << l_error.get_unique() << ',' << l_error.get_tid() << ',';
+            write_field(p_content.get_symbol(l_error.get_kind()));
+            m_file << ',';
+            write_field(l_error.get_what());
+            m_file << ',';
+            write_field(l_error.get_aux_what());
+            m_file << ',';
+            if(l_error.has_xwhat())
+            {
+                write_field(l_error.get_xwhat().get_text());
+                m_file << ',' << l_error.get_xwhat().get_leaked_bytes() << ',' << l_error.get_xwhat().get_leaked_blocks();
+            }
+            else
+            {
+                m_file << ",,";
+            }
+            m_file << ',' << l_error.get_stack_size() << ',' << p_statistics.get_stack_error(l_index) << ',';
+            if(l_error.get_stack_size())
+            {
+                const valgrind_frame & l_frame = l_frames.get(l_error.get_stack()[0]);
+                m_file << l_frame.get_ip() << ',';
+                write_field(p_content.get_symbol(l_frame.get_obj()));
+                m_file << ',';
+                write_field(p_content.get_symbol(l_frame.get_fn()));
+                m_file << ',';
+                write_field(p_content.get_symbol(l_frame.get_dir()));
+                m_file << ',';
+                write_field(p_content.get_symbol(l_frame.get_file()));
+                m_file << ',' << l_frame.get_line() << '\n';
+            }
+            else
+            {
+                m_file << ",,,,,\n";
+            }
+        }
+
+        m_file.close();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    csv_generator::write_field(const string_ref & p_field)
+    {
+        bool l_quoted = false;
+        for(auto l_char: p_field)
+        {
+            if(',' == l_char || '"' == l_char || '\n' == l_char || '\r' == l_char)
+            {
+                l_quoted = true;
+                break;
+            }
+        }
+        if(!l_quoted)
+        {
+            m_file.write(p_field.data(), p_field.size());
+            return;
+        }
+        m_file << '"';
+        for(auto l_char: p_field)
+        {
+            if('"' == l_char)
+            {
+                m_file << '"';
+            }
+            m_file << l_char;
+        }
+        m_file << '"';
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_CSV_GENERATOR_H
+// EOF
@@ -0,0 +1,178 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_FD_STREAMBUF_H
+#define VALGRIND_LOG_TOOL_FD_STREAMBUF_H
+
+#include "quicky_exception.h"
+#include <streambuf>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream buffer reading a file descriptor, for example a socket. Data
+     * is returned as soon as it is received
+     */
+    class fd_streambuf: public std::streambuf
+    {
+      public:
+
+        /**
+         * @param p_file_descriptor descriptor to read, it is closed by
+         * destructor
+         * @param p_name name used in error messages
+         */
+        inline
+        fd_streambuf( int p_file_descriptor
+                    , const std::string & p_name
+                    );
+
+        fd_streambuf(const fd_streambuf &) = delete;
+
+        fd_streambuf & operator=(const fd_streambuf &) = delete;
+
+        inline
+        ~fd_streambuf() override;
+
+      protected:
+
+        inline
+        int_type underflow() override;
+
+        /**
+         * Return characters already available instead of waiting for the
+         * whole requested size like default implementation does
+         */
+        inline
+        std::streamsize xsgetn( char * p_destination
+                              , std::streamsize p_size
+                              ) override;
+
+        /**
+         * Called when all data available in descriptor has been read
+         * @return true if more data should be read, false if end of stream
+         * is reached
+         */
+        inline virtual
+        bool wait_data();
+
+        /**
+         * @return number of bytes read from descriptor so far
+         */
+        inline
+        uint64_t get_received_size() const;
+
+      private:
+
+        int m_file_descriptor;
+        std::string m_name;
+        std::vector<char> m_buffer;
+
+        uint64_t m_received_size;
+    };
+
+    //-------------------------------------------------------------------------
+    fd_streambuf::fd_streambuf( int p_file_descriptor
+                              , const std::string & p_name
+                              )
+    : m_file_descriptor(p_file_descriptor)
+    , m_name(p_name)
+    , m_buffer(1 << 16)
+    , m_received_size(0)
+    {
+        setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+    }
+
+    //-------------------------------------------------------------------------
+    fd_streambuf::~fd_streambuf()
+    {
+        close(m_file_descriptor);
+    }
+
+    //-------------------------------------------------------------------------
+    fd_streambuf::int_type
+    fd_streambuf::underflow()
+    {
+        if(gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+        for(;;)
+        {
+            ssize_t l_read = read(m_file_descriptor, m_buffer.data(), m_buffer.size());
+            if(l_read > 0)
+            {
+                m_received_size += l_read;
+                setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + l_read);
+                return traits_type::to_int_type(*gptr());
+            }
+            if(l_read < 0)
+            {
+                if(EINTR == errno)
+                {
+                    continue;
+                }
+                throw quicky_exception::quicky_runtime_exception("Unable to read \"" + m_name + "\": " + strerror(errno), __LINE__, __FILE__);
+            }
+            if(!wait_data())
+            {
+                return traits_type::eof();
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    std::streamsize
+    fd_streambuf::xsgetn( char * p_destination
+                        , std::streamsize p_size
+                        )
+    {
+        if(p_size <= 0 || traits_type::eq_int_type(underflow(), traits_type::eof()))
+        {
+            return 0;
+        }
+        std::streamsize l_size = std::min(p_size, static_cast<std::streamsize>(egptr() - gptr()));
+        memcpy(p_destination, gptr(), l_size);
+        gbump(static_cast<int>(l_size));
+        return l_size;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    fd_streambuf::wait_data()
+    {
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    uint64_t
+    fd_streambuf::get_received_size() const
+    {
+        return m_received_size;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_FD_STREAMBUF_H
+// EOF
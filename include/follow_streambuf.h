@@ -0,0 +1,146 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_FOLLOW_STREAMBUF_H
+#define VALGRIND_LOG_TOOL_FOLLOW_STREAMBUF_H
+
+#include "fd_streambuf.h"
+#include "quicky_exception.h"
+#include <string>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream buffer reading a file that is still being written, like
+     * tail -f: when all written data has been read it waits for new data
+     * instead of reporting end of file. Reader is expected to stop by
+     * itself, for example once XML root element is closed. If the writer
+     * dies before, following can be stopped by the wait function or after
+     * a time without new data, end of file being then reported
+     */
+    class follow_streambuf: public fd_streambuf
+    {
+      public:
+
+        /**
+         * @param p_file_name file to follow
+         * @param p_wait function called each time all available data has
+         * been read, before waiting for new data. Following stops if it
+         * returns false
+         * @param p_timeout time without new data after which following
+         * stops, 0 to wait forever
+         * @param p_poll_period delay between two attempts to read new data
+         */
+        inline
+        follow_streambuf( const std::string & p_file_name
+                        , const std::function<bool()> & p_wait
+                        , std::chrono::seconds p_timeout = std::chrono::seconds(0)
+                        , std::chrono::milliseconds p_poll_period = std::chrono::milliseconds(200)
+                        );
+
+        /**
+         * @return true if following has been stopped by wait function or
+         * timeout, so file may be incomplete
+         */
+        inline
+        bool is_stopped() const;
+
+      protected:
+
+        inline
+        bool wait_data() override;
+
+      private:
+
+        inline static
+        int open_file(const std::string & p_file_name);
+
+        std::function<bool()> m_wait;
+        std::chrono::seconds m_timeout;
+        std::chrono::milliseconds m_poll_period;
+
+        /**
+         * Number of bytes received and time when it changed
+         */
+        uint64_t m_received_size;
+        std::chrono::steady_clock::time_point m_received_time;
+
+        bool m_stopped;
+    };
+
+    //-------------------------------------------------------------------------
+    follow_streambuf::follow_streambuf( const std::string & p_file_name
+                                      , const std::function<bool()> & p_wait
+                                      , std::chrono::seconds p_timeout
+                                      , std::chrono::milliseconds p_poll_period
+                                      )
+    : fd_streambuf(open_file(p_file_name), p_file_name)
+    , m_wait(p_wait)
+    , m_timeout(p_timeout)
+    , m_poll_period(p_poll_period)
+    , m_received_size(0)
+    , m_received_time(std::chrono::steady_clock::now())
+    , m_stopped(false)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    follow_streambuf::is_stopped() const
+    {
+        return m_stopped;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    follow_streambuf::wait_data()
+    {
+        auto l_now = std::chrono::steady_clock::now();
+        if(get_received_size() != m_received_size)
+        {
+            m_received_size = get_received_size();
+            m_received_time = l_now;
+        }
+        if(!m_wait() || (m_timeout.count() && l_now - m_received_time >= m_timeout))
+        {
+            m_stopped = true;
+            return false;
+        }
+        std::this_thread::sleep_for(m_poll_period);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    int
+    follow_streambuf::open_file(const std::string & p_file_name)
+    {
+        int l_file_descriptor = open(p_file_name.c_str(), O_RDONLY);
+        if(-1 == l_file_descriptor)
+        {
+            throw quicky_exception::quicky_runtime_exception("File \"" + p_file_name + "\" not found", __LINE__, __FILE__);
+        }
+        return l_file_descriptor;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_FOLLOW_STREAMBUF_H
+// EOF
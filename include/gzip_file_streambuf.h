@@ -0,0 +1,525 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_GZIP_FILE_STREAMBUF_H
+#define VALGRIND_LOG_TOOL_GZIP_FILE_STREAMBUF_H
+
+#include "output_file_streambuf.h"
+#include "quicky_exception.h"
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream buffer writing a gzip file. Data is cut in blocks, each block
+     * being compressed as a raw deflate stream primed with the 32 KB of
+     * data preceding it, so that blocks can be compressed by several
+     * threads and still form a single gzip member once written in order.
+     * Compressed file only depends on data, not on number of threads
+     */
+    class gzip_file_streambuf: public std::streambuf
+    {
+      public:
+
+        /**
+         * Create or truncate file
+         * @param p_name name of file
+         * @param p_jobs number of threads compressing blocks, blocks are
+         * compressed by writing thread if lower than 2
+         * @param p_block_size size of blocks in bytes
+         */
+        inline explicit
+        gzip_file_streambuf( const std::string & p_name
+                           , unsigned int p_jobs = 1
+                           , size_t p_block_size = 1 << 20
+                           );
+
+        gzip_file_streambuf(const gzip_file_streambuf &) = delete;
+
+        gzip_file_streambuf & operator=(const gzip_file_streambuf &) = delete;
+
+        /**
+         * Close file if not done. Errors are lost, file should be closed
+         * and checked before
+         */
+        inline
+        ~gzip_file_streambuf() override;
+
+        /**
+         * Compress remaining data, write gzip trailer and close file.
+         * Nothing can be written after
+         * @return true if whole file has been written
+         */
+        inline
+        bool close();
+
+        /**
+         * @return description of first compression or write error, empty
+         * if none
+         */
+        inline
+        const std::string & get_error() const;
+
+      protected:
+
+        inline
+        int_type overflow(int_type p_char) override;
+
+        inline
+        std::streamsize xsputn( const char * p_source
+                              , std::streamsize p_size
+                              ) override;
+
+        inline
+        int sync() override;
+
+      private:
+
+        /**
+         * Size of deflate window, amount of data preceding a block used to
+         * prime its compression
+         */
+        static const size_t m_window_size = 32768;
+
+        struct t_block
+        {
+            std::vector<char> m_input;
+            std::vector<char> m_dictionary;
+            std::vector<char> m_output;
+            uLong m_crc;
+            bool m_last;
+            bool m_taken;
+            bool m_done;
+            std::string m_error;
+        };
+
+        /**
+         * Compress data of put area as a block
+         * @param p_last true if block ends compressed data
+         * @return true if no error occured
+         */
+        inline
+        bool submit(bool p_last);
+
+        /**
+         * Write blocks being compressed by threads
+         * @param p_kept number of last blocks that can stay unwritten
+         */
+        inline
+        void write_blocks(size_t p_kept);
+
+        /**
+         * Write compressed block and account its data in trailer
+         */
+        inline
+        void write_block(const t_block & p_block);
+
+        /**
+         * Compress blocks not yet taken by other threads until buffer is
+         * closed
+         */
+        inline
+        void work();
+
+        inline static
+        void init_stream(z_stream & p_stream);
+
+        inline static
+        void compress( z_stream & p_stream
+                     , t_block & p_block
+                     );
+
+        output_file_streambuf m_file;
+        size_t m_block_size;
+        std::vector<char> m_buffer;
+
+        /**
+         * Last data written, up to deflate window size
+         */
+        std::vector<char> m_dictionary;
+
+        uLong m_crc;
+        uLong m_size;
+        bool m_closed;
+        std::string m_error;
+
+        /**
+         * Stream compressing blocks when there is no thread
+         */
+        z_stream m_stream;
+
+        /**
+         * Blocks not yet written in data order
+         */
+        std::deque<std::unique_ptr<t_block>> m_blocks;
+        size_t m_window;
+        bool m_stop;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::vector<std::thread> m_threads;
+    };
+
+    //-------------------------------------------------------------------------
+    gzip_file_streambuf::gzip_file_streambuf( const std::string & p_name
+                                            , unsigned int p_jobs
+                                            , size_t p_block_size
+                                            )
+    : m_file(p_name)
+    , m_block_size(p_block_size)
+    , m_buffer(p_block_size)
+    , m_crc(crc32(0L, Z_NULL, 0))
+    , m_size(0)
+    , m_closed(false)
+    , m_window(2 * p_jobs)
+    , m_stop(false)
+    {
+        memset(&m_stream, 0, sizeof(m_stream));
+        init_stream(m_stream);
+        // Header without name nor modification time, from an Unix system
+        const char l_header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, 3};
+        m_file.sputn(l_header, sizeof(l_header));
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        for(unsigned int l_index = 0; p_jobs > 1 && l_index < p_jobs; ++l_index)
+        {
+            m_threads.emplace_back(&gzip_file_streambuf::work, this);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    gzip_file_streambuf::~gzip_file_streambuf()
+    {
+        close();
+        deflateEnd(&m_stream);
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    gzip_file_streambuf::close()
+    {
+        if(!m_closed)
+        {
+            submit(true);
+            write_blocks(0);
+            {
+                std::lock_guard<std::mutex> l_lock(m_mutex);
+                m_stop = true;
+            }
+            m_condition.notify_all();
+            for(auto & l_iter: m_threads)
+            {
+                l_iter.join();
+            }
+            m_threads.clear();
+            m_closed = true;
+            setp(nullptr, nullptr);
+            if(m_error.empty())
+            {
+                // Trailer stores CRC and size modulo 2^32 in little endian
+                char l_trailer[8];
+                for(unsigned int l_index = 0; l_index < 4; ++l_index)
+                {
+                    l_trailer[l_index] = static_cast<char>((m_crc >> (8 * l_index)) & 0xFF);
+                    l_trailer[4 + l_index] = static_cast<char>((m_size >> (8 * l_index)) & 0xFF);
+                }
+                m_file.sputn(l_trailer, sizeof(l_trailer));
+                if(!m_file.close())
+                {
+                    m_error = m_file.get_error().empty() ? "Unable to write compressed file" : m_file.get_error();
+                }
+            }
+        }
+        return m_error.empty();
+    }
+
+    //-------------------------------------------------------------------------
+    const std::string &
+    gzip_file_streambuf::get_error() const
+    {
+        return m_error;
+    }
+
+    //-------------------------------------------------------------------------
+    gzip_file_streambuf::int_type
+    gzip_file_streambuf::overflow(int_type p_char)
+    {
+        if(m_closed || !submit(false))
+        {
+            return traits_type::eof();
+        }
+        if(!traits_type::eq_int_type(p_char, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(p_char);
+            pbump(1);
+        }
+        return traits_type::not_eof(p_char);
+    }
+
+    //-------------------------------------------------------------------------
+    std::streamsize
+    gzip_file_streambuf::xsputn( const char * p_source
+                               , std::streamsize p_size
+                               )
+    {
+        std::streamsize l_written = 0;
+        while(l_written < p_size)
+        {
+            if(pptr() == epptr() && (m_closed || !submit(false)))
+            {
+                break;
+            }
+            std::streamsize l_size = std::min(p_size - l_written, static_cast<std::streamsize>(epptr() - pptr()));
+            memcpy(pptr(), p_source + l_written, l_size);
+            pbump(static_cast<int>(l_size));
+            l_written += l_size;
+        }
+        return l_written;
+    }
+
+    //-------------------------------------------------------------------------
+    int
+    gzip_file_streambuf::sync()
+    {
+        if(!m_closed && (pptr() == pbase() || submit(false)))
+        {
+            write_blocks(0);
+            if(m_error.empty() && m_file.pubsync())
+            {
+                m_error = m_file.get_error().empty() ? "Unable to write compressed file" : m_file.get_error();
+            }
+        }
+        return m_error.empty() ? 0 : -1;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    gzip_file_streambuf::submit(bool p_last)
+    {
+        if(!m_error.empty())
+        {
+            return false;
+        }
+        size_t l_size = pptr() - pbase();
+        std::unique_ptr<t_block> l_block(new t_block());
+        l_block->m_last = p_last;
+        l_block->m_taken = false;
+        l_block->m_done = false;
+        m_buffer.resize(l_size);
+        l_block->m_input.swap(m_buffer);
+        l_block->m_dictionary = m_dictionary;
+
+        // Next block is primed with the end of data written so far
+        const std::vector<char> & l_input = l_block->m_input;
+        if(l_size >= m_window_size)
+        {
+            m_dictionary.assign(l_input.end() - m_window_size, l_input.end());
+        }
+        else
+        {
+            m_dictionary.insert(m_dictionary.end(), l_input.begin(), l_input.end());
+            if(m_dictionary.size() > m_window_size)
+            {
+                m_dictionary.erase(m_dictionary.begin(), m_dictionary.end() - m_window_size);
+            }
+        }
+
+        if(m_threads.empty())
+        {
+            compress(m_stream, *l_block);
+            write_block(*l_block);
+            m_buffer.swap(l_block->m_input);
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> l_lock(m_mutex);
+                m_blocks.push_back(std::move(l_block));
+            }
+            m_condition.notify_all();
+            // Compression stays a few blocks ahead of writing so that
+            // data is not held in memory
+            write_blocks(m_window);
+        }
+        m_buffer.resize(m_block_size);
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        return m_error.empty();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    gzip_file_streambuf::write_blocks(size_t p_kept)
+    {
+        for(;;)
+        {
+            std::unique_ptr<t_block> l_block;
+            {
+                std::unique_lock<std::mutex> l_lock(m_mutex);
+                if(m_blocks.size() <= p_kept)
+                {
+                    return;
+                }
+                m_condition.wait(l_lock, [&](){return m_blocks.front()->m_done;});
+                l_block = std::move(m_blocks.front());
+                m_blocks.pop_front();
+            }
+            m_condition.notify_all();
+            write_block(*l_block);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    gzip_file_streambuf::write_block(const t_block & p_block)
+    {
+        if(!m_error.empty())
+        {
+            return;
+        }
+        if(!p_block.m_error.empty())
+        {
+            m_error = p_block.m_error;
+            return;
+        }
+        m_crc = crc32_combine(m_crc, p_block.m_crc, static_cast<z_off_t>(p_block.m_input.size()));
+        m_size += static_cast<uLong>(p_block.m_input.size());
+        if(m_file.sputn(p_block.m_output.data(), p_block.m_output.size()) != static_cast<std::streamsize>(p_block.m_output.size()))
+        {
+            m_error = m_file.get_error().empty() ? "Unable to write compressed file" : m_file.get_error();
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    gzip_file_streambuf::work()
+    {
+        z_stream l_stream;
+        memset(&l_stream, 0, sizeof(l_stream));
+        std::string l_error;
+        try
+        {
+            init_stream(l_stream);
+        }
+        catch(const quicky_exception::quicky_runtime_exception & e)
+        {
+            l_error = e.what();
+        }
+        for(;;)
+        {
+            t_block * l_block = nullptr;
+            {
+                std::unique_lock<std::mutex> l_lock(m_mutex);
+                const auto l_find = [&]()
+                {
+                    for(auto & l_iter: m_blocks)
+                    {
+                        if(!l_iter->m_taken)
+                        {
+                            l_block = l_iter.get();
+                            return true;
+                        }
+                    }
+                    return m_stop;
+                };
+                m_condition.wait(l_lock, l_find);
+                if(!l_block)
+                {
+                    break;
+                }
+                l_block->m_taken = true;
+            }
+            if(l_error.empty())
+            {
+                compress(l_stream, *l_block);
+            }
+            else
+            {
+                l_block->m_error = l_error;
+            }
+            {
+                std::lock_guard<std::mutex> l_lock(m_mutex);
+                l_block->m_done = true;
+            }
+            m_condition.notify_all();
+        }
+        deflateEnd(&l_stream);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    gzip_file_streambuf::init_stream(z_stream & p_stream)
+    {
+        // Negative window bits produce raw deflate data, header and
+        // trailer being written by this buffer
+        if(Z_OK != deflateInit2(&p_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY))
+        {
+            throw quicky_exception::quicky_runtime_exception("Unable to initialise gzip compression", __LINE__, __FILE__);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    gzip_file_streambuf::compress( z_stream & p_stream
+                                 , t_block & p_block
+                                 )
+    {
+        deflateReset(&p_stream);
+        if(!p_block.m_dictionary.empty())
+        {
+            deflateSetDictionary(&p_stream, reinterpret_cast<const Bytef *>(p_block.m_dictionary.data()), static_cast<uInt>(p_block.m_dictionary.size()));
+        }
+        p_block.m_crc = crc32(0L, reinterpret_cast<const Bytef *>(p_block.m_input.data()), static_cast<uInt>(p_block.m_input.size()));
+        p_block.m_output.resize(deflateBound(&p_stream, static_cast<uLong>(p_block.m_input.size())) + 16);
+        p_stream.next_in = reinterpret_cast<Bytef *>(p_block.m_input.data());
+        p_stream.avail_in = static_cast<uInt>(p_block.m_input.size());
+        p_stream.next_out = reinterpret_cast<Bytef *>(p_block.m_output.data());
+        p_stream.avail_out = static_cast<uInt>(p_block.m_output.size());
+        // Blocks other than last end on a byte boundary so that next one
+        // can follow them
+        int l_flush = p_block.m_last ? Z_FINISH : Z_SYNC_FLUSH;
+        for(;;)
+        {
+            int l_result = deflate(&p_stream, l_flush);
+            if(Z_STREAM_ERROR == l_result)
+            {
+                p_block.m_error = "Unable to compress data";
+                return;
+            }
+            if(p_block.m_last ? Z_STREAM_END == l_result : 0 != p_stream.avail_out)
+            {
+                break;
+            }
+            size_t l_used = p_block.m_output.size() - p_stream.avail_out;
+            p_block.m_output.resize(p_block.m_output.size() + 65536);
+            p_stream.next_out = reinterpret_cast<Bytef *>(p_block.m_output.data() + l_used);
+            p_stream.avail_out = static_cast<uInt>(p_block.m_output.size() - l_used);
+        }
+        p_block.m_output.resize(p_block.m_output.size() - p_stream.avail_out);
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_GZIP_FILE_STREAMBUF_H
+// EOF
@@ -19,1100 +19,1516 @@
 #ifndef VALGRIND_LOG_TOOL_HTML_GENERATOR_H
 #define VALGRIND_LOG_TOOL_HTML_GENERATOR_H
 
+#include "valgrind_log_statistics.h"
 #include "valgrind_log_content.h"
+#include "report_generator.h"
+#include "report_file.h"
 #include "quicky_exception.h"
-#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace valgrind_log_tool
 {
-    class html_generator
+    class html_generator: public report_generator
     {
       public:
 
+        /**
+         * @param p_output_name name of report file, or of report directory
+         * when report is split in pages
+         * @param p_jobs number of threads rendering report sections
+         * @param p_pages true to write report as several pages in a
+         * directory instead of a single file
+         * @param p_compressed true to write report files compressed with
+         * gzip, ".gz" being added to page names
+         */
         inline
-        html_generator(const std::string & p_output_file_name);
+        html_generator( const std::string & p_output_name
+                      , unsigned int p_jobs = 1
+                      , bool p_pages = false
+                      , bool p_compressed = false
+                      );
 
         inline
-        ~html_generator();
+        ~html_generator() override;
 
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
         inline
-        void generate(const valgrind_log_content & p_content);
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) override;
 
       private:
 
+        typedef std::multimap<unsigned int, uint32_t>::const_iterator t_symbol_iterator;
+        typedef std::multimap<unsigned int, size_t>::const_iterator t_error_iterator;
+
+        /**
+         * Symbol of a sorted list and rank of one of its errors
+         */
+        typedef std::pair<t_symbol_iterator, size_t> t_symbol_position;
+
+        typedef std::function<const std::vector<uint32_t> & (uint32_t)> t_error_getter;
+        typedef std::function<void(std::ostream &)> t_section;
+
+        /**
+         * Name of page file and function writing page body
+         */
+        typedef std::pair<std::string, t_section> t_page;
+
+        /**
+         * Split a list of items in pages whose cost do not exceed budget,
+         * except if made of a single item
+         * @param p_begin first item
+         * @param p_end item following last one
+         * @param p_cost function returning cost of an item
+         * @param p_budget maximum cost of a page
+         * @return first item of each page followed by p_end
+         */
+        template <typename ITERATOR, typename COST>
+        std::vector<ITERATOR> split_pages( ITERATOR p_begin
+                                         , ITERATOR p_end
+                                         , const COST & p_cost
+                                         , size_t p_budget
+                                         ) const;
+
+        /**
+         * Split an "Errors per" section in pages. Errors of a symbol too
+         * many for a single page are continued in following pages
+         * @param p_sorted sorted symbols of section
+         * @param p_cost number of lines of a symbol besides its errors
+         * @param p_get_errors function returning errors of a symbol
+         * @return position of first error of each page followed by end of
+         * sorted symbols
+         */
+        inline
+        std::vector<t_symbol_position> split_symbol_pages( const std::multimap<unsigned int, uint32_t> & p_sorted
+                                                         , size_t p_cost
+                                                         , const t_error_getter & p_get_errors
+                                                         ) const;
+
+        /**
+         * Move to page where a symbol begins, symbols being visited in
+         * sorted order
+         * @param p_pages pages of an "Errors per" section
+         * @param p_symbol symbol
+         * @param p_page index of current page, updated
+         */
+        inline static
+        void seek_page( const std::vector<t_symbol_position> & p_pages
+                      , t_symbol_iterator p_symbol
+                      , size_t & p_page
+                      );
+
+        /**
+         * Call a function for each symbol between two positions with the
+         * range of its errors between those positions
+         */
+        template <typename FUNCTION>
+        void process_positions( t_symbol_position p_begin
+                              , t_symbol_position p_end
+                              , const t_error_getter & p_get_errors
+                              , const FUNCTION & p_function
+                              ) const;
+
+        /**
+         * @return maximum number of lines of a page, unlimited for a
+         * single file report
+         */
+        inline
+        size_t get_page_budget() const;
+
         /**
-         * Compute kind id that will be uased as local anchor
-         * @param p_kind string representing error kind
-         * @return string representing kind id
+         * @param p_base name shared by pages of a section
+         * @param p_page index of page in section
+         * @return file name of page, empty for a single file report so
+         * that links remain local
          */
         inline
-        std::string get_kind_id(const std::string & p_kind) const;
+        std::string get_page_name( const std::string & p_base
+                                 , size_t p_page
+                                 ) const;
 
+        /**
+         * Compute once anchor ids and links of kinds, files, objects,
+         * functions, directories, errors and the table row of each frame,
+         * as they are written many times
+         */
         inline
-        std::string get_kind_link(const std::string & p_kind) const;
+        void prepare_markup(const valgrind_log_content & p_content);
 
         /**
-         * Compute file id that will be used as local anchor
-         * @param p_file string representing error frame file
-         * @return string representing file id
+         * @param p_kind id of error kind in content symbol table
+         * @return kind id used as local anchor
          */
         inline
-        std::string get_file_id(const std::string & p_file) const;
+        const std::string & get_kind_id(uint32_t p_kind) const;
 
         inline
-        std::string get_file_link(const std::string & p_kind) const;
+        const std::string & get_kind_link(uint32_t p_kind) const;
 
         /**
-         * Compute object id that will be used as local anchor
-         * @param p_object string representing error frame object
-         * @return string representing object id
+         * @param p_file id of error frame file in content symbol table
+         * @return file id used as local anchor
          */
         inline
-        std::string get_object_id(const std::string & p_object) const;
+        const std::string & get_file_id(uint32_t p_file) const;
 
         inline
-        std::string get_object_link(const std::string & p_object) const;
+        const std::string & get_file_link(uint32_t p_file) const;
 
         /**
-         * Compute function id that will be used as local anchor
-         * @param p_function string representing error frame function
-         * @return string representing function id
+         * @param p_object id of error frame object in content symbol table
+         * @return object id used as local anchor
          */
         inline
-        std::string get_function_id(const std::string & p_function) const;
+        const std::string & get_object_id(uint32_t p_object) const;
 
         inline
-        std::string get_function_link(const std::string & p_function) const;
+        const std::string & get_object_link(uint32_t p_object) const;
 
         /**
-         * Compute directory id that will be used as local anchor
-         * @param p_directory string representing error frame directory
-         * @return string representing directory id
+         * @param p_function id of error frame function in content symbol
+         * table
+         * @return function id used as local anchor
          */
         inline
-        std::string get_directory_id(const std::string & p_directory) const;
+        const std::string & get_function_id(uint32_t p_function) const;
 
         inline
-        std::string get_directory_link(const std::string & p_directory) const;
+        const std::string & get_function_link(uint32_t p_function) const;
 
         /**
-         * Compute frame id that will be used as local anchor
-         * @param p_frame error frame
-         * @return string representing frame id
+         * @param p_directory id of error frame directory in content symbol
+         * table
+         * @return directory id used as local anchor
          */
         inline
-        std::string get_frame_id(const valgrind_frame & p_frame) const;
+        const std::string & get_directory_id(uint32_t p_directory) const;
 
         inline
-        std::string get_frame_link(const valgrind_frame & p_frame) const;
+        const std::string & get_directory_link(uint32_t p_directory) const;
 
+        /**
+         * @param p_frame index of frame in content frame table
+         * @return frame id used as local anchor
+         */
         inline
-        std::string get_error_id(const valgrind_error & p_error) const;
+        const std::string & get_frame_id(uint32_t p_frame) const;
 
+        /**
+         * Error id used as local anchor. When several log files are
+         * reported it contains source index as error unique ids are only
+         * unique in their log file
+         * @param p_error index of error in content error table
+         * @return string representing error id
+         */
         inline
-        std::string get_error_link(const valgrind_error & p_error) const;
+        const std::string & get_error_id(size_t p_error) const;
 
+        /**
+         * Text used to designate an error, prefixed by its pid when several
+         * log files are reported
+         */
         inline
-        void collect_error_info(const valgrind_log_content & p_content);
+        const std::string & get_error_name(size_t p_error) const;
 
         inline
-        void collect_kind_info(const valgrind_log_content & p_content);
+        const std::string & get_error_link(size_t p_error) const;
 
+        /**
+         * Write sections in report order. With several jobs sections are
+         * rendered in parallel
+         * @param p_sections functions writing each section in a stream
+         */
         inline
-        void collect_file_info(const valgrind_log_content & p_content);
+        void generate_sections(const std::vector<t_section> & p_sections);
 
+        /**
+         * Write each page in its own file of report directory. With
+         * several jobs pages are written in parallel
+         */
         inline
-        void collect_object_info(const valgrind_log_content & p_content);
+        void generate_pages(const std::vector<t_page> & p_pages);
 
+        /**
+         * Write a page file: document head, body and document end
+         */
         inline
-        void collect_function_info(const valgrind_log_content & p_content);
+        void generate_page(const t_page & p_page);
 
+        /**
+         * Write links to index, previous and next pages of a section
+         * @param p_base name shared by pages of section
+         * @param p_page index of page in section
+         * @param p_page_number number of pages of section
+         */
+        inline
+        void generate_navigation_html( const std::string & p_base
+                                     , size_t p_page
+                                     , size_t p_page_number
+                                     , std::ostream & p_stream
+                                     );
+
+        inline
+        void generate_head_html(std::ostream & p_stream);
+
+        /**
+         * Write links to report lists
+         */
         inline
-        void collect_directory_info(const valgrind_log_content & p_content);
+        void generate_summary_list_html(std::ostream & p_stream);
 
+        /**
+         * Write document head, summary and lists of encountered kinds,
+         * files, objects, functions and directories
+         */
         inline
-        void collect_frame_info(const valgrind_log_content & p_content);
+        void generate_summary_html(std::ostream & p_stream);
 
+        /**
+         * Write symbols of a field with their number of occurences
+         * @param p_id anchor id of list
+         * @param p_title title of list
+         * @param p_links symbol links indexed by symbol id
+         */
         inline
-        void generate_html(const valgrind_error & p_error);
+        void generate_encountered_symbols_html( const std::string & p_id
+                                              , const std::string & p_title
+                                              , const std::vector<std::string> & p_links
+                                              , t_symbol_iterator p_begin
+                                              , t_symbol_iterator p_end
+                                              , std::ostream & p_stream
+                                              );
 
         inline
-        void generate_html_frame_array_start();
+        void generate_encountered_errors_html( const valgrind_log_content & p_content
+                                             , t_error_iterator p_begin
+                                             , t_error_iterator p_end
+                                             , std::ostream & p_stream
+                                             );
 
         inline
-        void generate_html_frame_array_end();
+        void generate_encountered_frames_html( t_symbol_iterator p_begin
+                                             , t_symbol_iterator p_end
+                                             , std::ostream & p_stream
+                                             );
+
+        /**
+         * Write details of a range of errors
+         * @param p_begin index of first error
+         * @param p_end index following last error
+         */
+        inline
+        void generate_errors_html( const valgrind_log_content & p_content
+                                 , size_t p_begin
+                                 , size_t p_end
+                                 , std::ostream & p_stream
+                                 );
 
         inline
-        void generate_html(const valgrind_frame & p_frame);
+        void generate_sources_html( const valgrind_log_content & p_content
+                                  , std::ostream & p_stream
+                                  );
 
+        /**
+         * @param p_index index of error in content error table
+         * @param p_content content owning error
+         */
         inline
-        void generate_kinds_html(const valgrind_log_content & p_content);
+        void generate_html( size_t p_index
+                          , const valgrind_log_content & p_content
+                          , std::ostream & p_stream
+                          );
 
         inline
-        void generate_files_html(const valgrind_log_content & p_content);
+        void generate_html_frame_array_start(std::ostream & p_stream);
 
         inline
-        void generate_objects_html(const valgrind_log_content & p_content);
+        void generate_html_frame_array_end(std::ostream & p_stream);
 
+        /**
+         * Write table row of a frame
+         * @param p_frame index of frame in content frame table
+         */
         inline
-        void generate_functions_html(const valgrind_log_content & p_content);
+        void generate_frame_html( uint32_t p_frame
+                                , std::ostream & p_stream
+                                );
 
+        /**
+         * Write links to errors of an "Errors per" section
+         * @param p_errors indexes of errors in content error table
+         * @param p_begin rank of first written error
+         * @param p_end rank following last written error
+         */
         inline
-        void generate_directories_html(const valgrind_log_content & p_content);
+        void generate_error_links( const std::vector<uint32_t> & p_errors
+                                 , size_t p_begin
+                                 , size_t p_end
+                                 , std::ostream & p_stream
+                                 );
 
+        /**
+         * Write an "Errors per" section of a symbol field
+         * @param p_title title of section
+         * @param p_description text introducing a symbol
+         * @param p_ids anchor ids indexed by symbol id
+         * @param p_statistics statistics of field
+         * @param p_begin position of first written error
+         * @param p_end position following last written error
+         */
         inline
-        void generate_frames_html(const valgrind_log_content & p_content);
+        void generate_symbol_errors_html( const std::string & p_title
+                                        , const std::string & p_description
+                                        , const std::vector<std::string> & p_ids
+                                        , const valgrind_symbol_statistics & p_statistics
+                                        , t_symbol_position p_begin
+                                        , t_symbol_position p_end
+                                        , std::ostream & p_stream
+                                        );
 
-        std::ofstream m_file;
+        inline
+        void generate_frames_html( const valgrind_log_content & p_content
+                                 , t_symbol_position p_begin
+                                 , t_symbol_position p_end
+                                 , std::ostream & p_stream
+                                 );
 
         /**
-         * List of errors and associated id
+         * Report directory, empty when report is a single file
          */
-        std::map<uint64_t, const valgrind_error *> m_errors;
+        std::string m_directory;
 
         /**
-         * Kind sorted per number of occurence
+         * Single file report, null when report is split in pages
          */
-        std::multimap<unsigned int, uint64_t> m_sorted_errors;
+        std::unique_ptr<report_file> m_file;
 
         /**
-         * List of kind and associated id
+         * True if report files are compressed
          */
-        std::map<std::string, unsigned int> m_kinds;
+        bool m_compressed;
 
         /**
-         * Kind sorted per number of occurence
+         * Number of threads rendering sections
          */
-        std::multimap<unsigned int, std::string> m_sorted_kinds;
+        unsigned int m_jobs;
 
         /**
-         * List of files and associated id
+         * Number of frames above which "Errors" section of a single file
+         * report is split in another chunk
          */
-        std::map<std::string, unsigned int> m_files;
+        static const size_t m_frames_per_chunk = 16384;
 
         /**
-         * files sorted per number of occurence
+         * Approximate number of lines above which a list is continued in
+         * another page, a frame table row counting for 8 lines
          */
-        std::multimap<unsigned int, std::string> m_sorted_files;
+        static const size_t m_lines_per_page = 16384;
 
         /**
-         * List of frame objects and associated id
+         * True if errors come from several log files
          */
-        std::map<std::string, unsigned int> m_objects;
+        bool m_multiple_sources;
 
         /**
-         * Objects sorted per number of occurence
+         * Content being reported, it provides names of symbols
          */
-        std::multimap<unsigned int, std::string> m_sorted_objects;
+        const valgrind_log_content * m_content;
 
         /**
-         * List of frame functions and associated id
+         * Statistics of content being reported
          */
-        std::map<std::string, unsigned int> m_functions;
+        const valgrind_log_statistics * m_statistics;
 
         /**
-         * functions sorted per number of occurence
+         * Position of first error of each page of "Errors per" sections
+         * followed by end of sorted symbols
          */
-        std::multimap<unsigned int, std::string> m_sorted_functions;
+        std::vector<t_symbol_position> m_kind_pages;
+        std::vector<t_symbol_position> m_file_pages;
+        std::vector<t_symbol_position> m_object_pages;
+        std::vector<t_symbol_position> m_function_pages;
+        std::vector<t_symbol_position> m_directory_pages;
+        std::vector<t_symbol_position> m_frame_pages;
 
         /**
-         * List of frame directories and associated id
+         * First error of each page, or chunk for a single file report, of
+         * "Errors" section followed by number of errors
          */
-        std::map<std::string, unsigned int> m_directories;
+        std::vector<size_t> m_error_pages;
 
         /**
-         * directories sorted per number of occurence
+         * Anchor ids and links indexed by symbol id, only set for symbols
+         * met in their field
          */
-        std::multimap<unsigned int, std::string> m_sorted_directories;
+        std::vector<std::string> m_kind_ids;
+        std::vector<std::string> m_kind_links;
+        std::vector<std::string> m_file_ids;
+        std::vector<std::string> m_file_links;
+        std::vector<std::string> m_object_ids;
+        std::vector<std::string> m_object_links;
+        std::vector<std::string> m_function_ids;
+        std::vector<std::string> m_function_links;
+        std::vector<std::string> m_directory_ids;
+        std::vector<std::string> m_directory_links;
 
         /**
-         * List of frames and associated ids
+         * Anchor ids, names and links indexed by error index
          */
-        std::map<uint64_t, const valgrind_frame *> m_frames;
+        std::vector<std::string> m_error_ids;
+        std::vector<std::string> m_error_names;
+        std::vector<std::string> m_error_links;
 
         /**
-         * Frames sorted per number of occurence
+         * Anchor ids and table rows indexed by frame index
          */
-        std::multimap<unsigned int, const valgrind_frame *> m_sorted_frames;
+        std::vector<std::string> m_frame_ids;
+        std::vector<std::string> m_frame_rows;
 
     };
 
     //-------------------------------------------------------------------------
-    html_generator::html_generator(const std::string & p_output_file_name)
+    html_generator::html_generator( const std::string & p_output_name
+                                  , unsigned int p_jobs
+                                  , bool p_pages
+                                  , bool p_compressed
+                                  )
+    : m_directory(p_pages ? p_output_name : "")
+    , m_file(p_pages ? nullptr : new report_file(p_output_name, p_compressed, p_jobs))
+    , m_compressed(p_compressed)
+    , m_jobs(p_jobs)
+    , m_multiple_sources(false)
+    , m_content(nullptr)
+    , m_statistics(nullptr)
     {
-        m_file.open(p_output_file_name);
-        if(!m_file.is_open())
+        if(p_pages && mkdir(p_output_name.c_str(), 0755) && EEXIST != errno)
         {
-            throw quicky_exception::quicky_runtime_exception("Unable to create file \"" + p_output_file_name + "\"", __LINE__, __FILE__);
+            throw quicky_exception::quicky_runtime_exception("Unable to create directory \"" + p_output_name + "\": " + strerror(errno), __LINE__, __FILE__);
         }
     }
 
     //-------------------------------------------------------------------------
     html_generator::~html_generator()
     {
-        m_file.close();
+
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::generate(const valgrind_log_content & p_content)
+    html_generator::generate( const valgrind_log_content & p_content
+                            , const valgrind_log_statistics & p_statistics
+                            )
     {
-        std::string l_title = "Valgrind_report";
-        m_file << "<!DOCTYPE html>" << std::endl;
-        m_file << "<html>" << std::endl;
-        m_file << "<head>" << std::endl;
-        m_file << R"(<meta http-equiv="Content-Type" content="text/html; charset=utf-8">)" << std::endl;
-        m_file << "<title>" << l_title << "</title>" << std::endl;
-        m_file << "</head>" << std::endl;
-        m_file << "<body>" << std::endl;
-        m_file << "<H1>" << l_title << "</H1>" << std::endl;
-
-        m_file << "<H2>Summary</H2>" << std::endl;
-        m_file << "<ul>" << std::endl;
-        m_file << R"(<li><a href="#Encountered_Kinds">Encountered Kinds</a></li>)";
-        m_file << R"(<li><a href="#Encountered_Files">Encountered Files</a></li>)";
-        m_file << R"(<li><a href="#Encountered_Objects">Encountered Objects</a></li>)";
-        m_file << R"(<li><a href="#Encountered_Functions">Encountered Functions</a></li>)";
-        m_file << R"(<li><a href="#Encountered_Errors">Encountered Errors</a></li>)";
-        m_file << R"(<li><a href="#Encountered_Frames">Encountered Frames</a></li>)";
-        m_file << "</ul>" << std::endl;
-
-        collect_kind_info(p_content);
-
-        m_file << R"(<H2 id="Encountered_Kinds">Encountered kinds</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_kinds)
-        {
-            m_file << "<li>" << get_kind_link(l_iter.second) << " : " << l_iter.first << "</li>" << std::endl;
-        }
-        m_file << "</ul>" << std::endl;
-
-        collect_file_info(p_content);
+        m_multiple_sources = p_content.get_source_number() > 1;
+        m_content = &p_content;
+        m_statistics = &p_statistics;
 
-        m_file << R"(<H2 id="Encountered_Files">Encountered files</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_files)
+        // Pages have to be known before links to their anchors are built
+        const auto l_split_symbol_pages = [&](const valgrind_symbol_statistics & p_field)
         {
-            m_file << "<li>" << get_file_link(l_iter.second) << " : " << l_iter.first << "</li>" << std::endl;
-        }
-        m_file << "</ul>" << std::endl;
-
-        collect_object_info(p_content);
-
-        m_file << R"(<H2 id="Encountered_Objects">Encountered Objects</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_objects)
-        {
-            m_file << "<li>" << get_object_link(l_iter.second) << " : " << l_iter.first << "</li>" << std::endl;
-        }
-        m_file << "</ul>" << std::endl;
-
-        collect_function_info(p_content);
-
-        m_file << R"(<H2 id="Encountered_Functions">Encountered Functions</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_functions)
+            return split_symbol_pages(p_field.get_sorted(), 2, [&](uint32_t p_symbol) -> const std::vector<uint32_t> & {return p_field.get_errors(p_symbol);});
+        };
+        m_kind_pages = l_split_symbol_pages(p_statistics.get_kinds());
+        m_file_pages = l_split_symbol_pages(p_statistics.get_files());
+        m_object_pages = l_split_symbol_pages(p_statistics.get_objects());
+        m_function_pages = l_split_symbol_pages(p_statistics.get_functions());
+        m_directory_pages = l_split_symbol_pages(p_statistics.get_directories());
+        m_frame_pages = split_symbol_pages(p_statistics.get_sorted_frames(), 20, [&](uint32_t p_frame) -> const std::vector<uint32_t> & {return p_statistics.get_frame_errors(p_frame);});
+        const std::vector<size_t> & l_offsets = p_content.get_errors().get_stack_offsets();
+        if(m_directory.empty())
         {
-            m_file << "<li>" << get_function_link(l_iter.second) << " : " << l_iter.first << "</li>" << std::endl;
+            // Long "Errors" section is split in chunks of about the same
+            // number of frames so that they can be rendered in parallel
+            const auto l_chunk_cost = [&](size_t p_index) -> size_t
+            {
+                return p_statistics.get_stack_error(p_index) == p_index ? l_offsets[p_index + 1] - l_offsets[p_index] : 1;
+            };
+            m_error_pages = split_pages(size_t(0), p_content.get_error_number(), l_chunk_cost, m_frames_per_chunk);
         }
-        m_file << "</ul>" << std::endl;
-
-        collect_directory_info(p_content);
-
-        m_file << R"(<H2 id="Encountered_Directories">Encountered Directories</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_directories)
+        else
         {
-            m_file << "<li>" << get_directory_link(l_iter.second) << " : " << l_iter.first << "</li>" << std::endl;
+            const auto l_error_cost = [&](size_t p_index) -> size_t
+            {
+                return 12 + (p_statistics.get_stack_error(p_index) == p_index ? 8 * (l_offsets[p_index + 1] - l_offsets[p_index]) : 0);
+            };
+            m_error_pages = split_pages(size_t(0), p_content.get_error_number(), l_error_cost, m_lines_per_page);
         }
-        m_file << "</ul>" << std::endl;
-
-        collect_error_info(p_content);
+        prepare_markup(p_content);
 
-        m_file << R"(<H2 id="Encountered_Errors">Encountered Errors</H2>)" << std::endl;
-        m_file << "<ul>" << std::endl;
-        for(const auto & l_iter: m_sorted_errors)
+        if(m_directory.empty())
         {
-
-            const valgrind_error & l_error = *m_errors[l_iter.second];
-            m_file << "<li> Error" << get_error_link(l_error) << "(" << get_kind_link(l_error.get_kind()) << ") : " << l_iter.first << "</li>" << std::endl;
+            // Sections in report order
+            std::vector<t_section> l_sections;
+            l_sections.push_back([&](std::ostream & p_stream){generate_summary_html(p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_encountered_errors_html(p_content, p_statistics.get_sorted_errors().begin(), p_statistics.get_sorted_errors().end(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_encountered_frames_html(p_statistics.get_sorted_frames().begin(), p_statistics.get_sorted_frames().end(), p_stream);});
+            if(m_multiple_sources)
+            {
+                l_sections.push_back([&](std::ostream & p_stream){generate_sources_html(p_content, p_stream);});
+            }
+            l_sections.push_back([&](std::ostream & p_stream){generate_symbol_errors_html("Errors per files", "Errors whose call stack mention file", m_file_ids, p_statistics.get_files(), m_file_pages.front(), m_file_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_symbol_errors_html("Errors per kind", "Errors of kind", m_kind_ids, p_statistics.get_kinds(), m_kind_pages.front(), m_kind_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_symbol_errors_html("Errors per objects", "Errors whose call stack mention object", m_object_ids, p_statistics.get_objects(), m_object_pages.front(), m_object_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_symbol_errors_html("Errors per functions", "Errors whose call stack mention function", m_function_ids, p_statistics.get_functions(), m_function_pages.front(), m_function_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_symbol_errors_html("Errors per directories", "Errors whose call stack mention directory", m_directory_ids, p_statistics.get_directories(), m_directory_pages.front(), m_directory_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){generate_frames_html(p_content, m_frame_pages.front(), m_frame_pages.back(), p_stream);});
+            l_sections.push_back([&](std::ostream & p_stream){p_stream << "<H2>Errors</H2>\n";});
+            for(size_t l_chunk = 0; l_chunk + 1 < m_error_pages.size(); ++l_chunk)
+            {
+                size_t l_begin = m_error_pages[l_chunk];
+                size_t l_end = m_error_pages[l_chunk + 1];
+                if(l_begin < l_end)
+                {
+                    l_sections.push_back([&, l_begin, l_end](std::ostream & p_stream){generate_errors_html(p_content, l_begin, l_end, p_stream);});
+                }
+            }
+            l_sections.push_back([&](std::ostream & p_stream){p_stream << "</body>\n" << "</html>\n";});
+            generate_sections(l_sections);
+            m_file->close();
         }
-        m_file << "</ul>" << std::endl;
-
-        collect_frame_info(p_content);
-
-        m_file << R"(<H2 id="Encountered_Frames">Encountered Frames</H2>)" << std::endl;
-        generate_html_frame_array_start();
-        for(const auto & l_iter: m_sorted_frames)
+        else
         {
-            generate_html(*l_iter.second);
+            std::vector<t_page> l_pages;
+            l_pages.push_back(t_page("index.html", [&](std::ostream & p_stream)
+                                                   {
+                                                       generate_summary_list_html(p_stream);
+                                                       if(m_multiple_sources)
+                                                       {
+                                                           generate_sources_html(p_content, p_stream);
+                                                       }
+                                                   }
+                                    )
+                             );
+            const auto l_add_pages = [&]( const std::string & p_base
+                                        , size_t p_page_number
+                                        , const std::function<void(size_t, std::ostream &)> & p_body
+                                        )
+            {
+                for(size_t l_page = 0; l_page < p_page_number; ++l_page)
+                {
+                    l_pages.push_back(t_page(get_page_name(p_base, l_page), [=](std::ostream & p_stream)
+                                                                            {
+                                                                                generate_navigation_html(p_base, l_page, p_page_number, p_stream);
+                                                                                p_body(l_page, p_stream);
+                                                                            }
+                                            )
+                                     );
+                }
+            };
+            const auto l_add_encountered_pages = [&]( const std::string & p_base
+                                                    , const std::string & p_id
+                                                    , const std::string & p_title
+                                                    , const valgrind_symbol_statistics & p_statistics
+                                                    , const std::vector<std::string> & p_links
+                                                    )
+            {
+                std::vector<t_symbol_iterator> l_bounds = split_pages(p_statistics.get_sorted().begin(), p_statistics.get_sorted().end(), [](t_symbol_iterator){return 1;}, m_lines_per_page);
+                l_add_pages(p_base, l_bounds.size() - 1, [=, &p_links](size_t p_page, std::ostream & p_stream)
+                                                         {
+                                                             generate_encountered_symbols_html(p_id, p_title, p_links, l_bounds[p_page], l_bounds[p_page + 1], p_stream);
+                                                         }
+                           );
+            };
+            l_add_encountered_pages("encountered_kinds", "Encountered_Kinds", "Encountered kinds", p_statistics.get_kinds(), m_kind_links);
+            l_add_encountered_pages("encountered_files", "Encountered_Files", "Encountered files", p_statistics.get_files(), m_file_links);
+            l_add_encountered_pages("encountered_objects", "Encountered_Objects", "Encountered Objects", p_statistics.get_objects(), m_object_links);
+            l_add_encountered_pages("encountered_functions", "Encountered_Functions", "Encountered Functions", p_statistics.get_functions(), m_function_links);
+            l_add_encountered_pages("encountered_directories", "Encountered_Directories", "Encountered Directories", p_statistics.get_directories(), m_directory_links);
+
+            std::vector<t_error_iterator> l_error_bounds = split_pages(p_statistics.get_sorted_errors().begin(), p_statistics.get_sorted_errors().end(), [](t_error_iterator){return 2;}, m_lines_per_page);
+            l_add_pages("encountered_errors", l_error_bounds.size() - 1, [&, l_error_bounds](size_t p_page, std::ostream & p_stream)
+                                                                         {
+                                                                             generate_encountered_errors_html(p_content, l_error_bounds[p_page], l_error_bounds[p_page + 1], p_stream);
+                                                                         }
+                       );
+            std::vector<t_symbol_iterator> l_frame_bounds = split_pages(p_statistics.get_sorted_frames().begin(), p_statistics.get_sorted_frames().end(), [](t_symbol_iterator){return 8;}, m_lines_per_page);
+            l_add_pages("encountered_frames", l_frame_bounds.size() - 1, [&, l_frame_bounds](size_t p_page, std::ostream & p_stream)
+                                                                         {
+                                                                             generate_encountered_frames_html(l_frame_bounds[p_page], l_frame_bounds[p_page + 1], p_stream);
+                                                                         }
+                       );
+
+            l_add_pages("files", m_file_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_symbol_errors_html("Errors per files", "Errors whose call stack mention file", m_file_ids, p_statistics.get_files(), m_file_pages[p_page], m_file_pages[p_page + 1], p_stream);});
+            l_add_pages("kinds", m_kind_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_symbol_errors_html("Errors per kind", "Errors of kind", m_kind_ids, p_statistics.get_kinds(), m_kind_pages[p_page], m_kind_pages[p_page + 1], p_stream);});
+            l_add_pages("objects", m_object_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_symbol_errors_html("Errors per objects", "Errors whose call stack mention object", m_object_ids, p_statistics.get_objects(), m_object_pages[p_page], m_object_pages[p_page + 1], p_stream);});
+            l_add_pages("functions", m_function_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_symbol_errors_html("Errors per functions", "Errors whose call stack mention function", m_function_ids, p_statistics.get_functions(), m_function_pages[p_page], m_function_pages[p_page + 1], p_stream);});
+            l_add_pages("directories", m_directory_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_symbol_errors_html("Errors per directories", "Errors whose call stack mention directory", m_directory_ids, p_statistics.get_directories(), m_directory_pages[p_page], m_directory_pages[p_page + 1], p_stream);});
+            l_add_pages("frames", m_frame_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream){generate_frames_html(p_content, m_frame_pages[p_page], m_frame_pages[p_page + 1], p_stream);});
+            l_add_pages("errors", m_error_pages.size() - 1, [&](size_t p_page, std::ostream & p_stream)
+                                                            {
+                                                                p_stream << "<H2>Errors</H2>\n";
+                                                                generate_errors_html(p_content, m_error_pages[p_page], m_error_pages[p_page + 1], p_stream);
+                                                            }
+                       );
+            generate_pages(l_pages);
         }
-        generate_html_frame_array_end();
-
-
-        generate_files_html(p_content);
-        generate_kinds_html(p_content);
-        generate_objects_html(p_content);
-        generate_functions_html(p_content);
-        generate_directories_html(p_content);
-        generate_frames_html(p_content);
-
-        const auto l_treat_error = [&](const valgrind_error & p_error)
-        {
-            this->generate_html(p_error);
-        };
-        m_file << "<H2>Errors</H2>" << std::endl;
-        p_content.process_errors(l_treat_error);
-
-        m_file << "</body>" << std::endl;
-        m_file << "</html>" << std::endl;
 
+        m_statistics = nullptr;
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::generate_html(const valgrind_error & p_error)
+    template <typename ITERATOR, typename COST>
+    std::vector<ITERATOR>
+    html_generator::split_pages( ITERATOR p_begin
+                               , ITERATOR p_end
+                               , const COST & p_cost
+                               , size_t p_budget
+                               ) const
     {
-        m_file << "<hr id=\"" << get_error_id(p_error) << "\">" << std::endl;
-        m_file << "Error <b>" << p_error.get_unique() << "</b>" << std::endl;
-        m_file << "<ul>" << std::endl;
-        m_file << "<li>Kind : <b>" << get_kind_link(p_error.get_kind()) << "</b></li>" << std::endl;
-        if(!p_error.get_what().empty())
-        {
-            m_file << "<li>What : <b>" << p_error.get_what() << "</b></li>" << std::endl;
-        }
-        if(!p_error.get_aux_what().empty())
-        {
-            m_file << "<li>Aux What : <b>" << p_error.get_aux_what() << "</b></li>" << std::endl;
-        }
-        if(p_error.has_xwhat())
+        std::vector<ITERATOR> l_bounds(1, p_begin);
+        size_t l_page_cost = 0;
+        for(ITERATOR l_iter = p_begin; l_iter != p_end; ++l_iter)
         {
-            m_file << "<li>What : <b>" << p_error.get_xwhat().get_text() << "</b></li>" << std::endl;
-            m_file << "<ul>" << std::endl;
-            m_file << "<li>Leaked bytes : <b>" << p_error.get_xwhat().get_leaked_bytes() << "</b></li>" << std::endl;
-            m_file << "<li>Leaked blocks : <b>" << p_error.get_xwhat().get_leaked_blocks() << "</b></li>" << std::endl;
-            m_file << "</ul>" << std::endl;
+            size_t l_cost = p_cost(l_iter);
+            if(l_page_cost && l_page_cost + l_cost > p_budget)
+            {
+                l_bounds.push_back(l_iter);
+                l_page_cost = 0;
+            }
+            l_page_cost += l_cost;
         }
-        m_file << "<li>Tid: <b>" << p_error.get_tid() << "</b></li>" << std::endl;
-        m_file << "<li>Call stack:</li>" << std::endl;
-
-        generate_html_frame_array_start();
-        const auto l_treat_frame = [&](const valgrind_frame & p_frame)
-        {
-            generate_html(p_frame);
-        };
-        p_error.process_stack(l_treat_frame);
-        generate_html_frame_array_end();
-
-        m_file << "</ul>" << std::endl;
+        l_bounds.push_back(p_end);
+        return l_bounds;
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::generate_html_frame_array_start()
+    std::vector<html_generator::t_symbol_position>
+    html_generator::split_symbol_pages( const std::multimap<unsigned int, uint32_t> & p_sorted
+                                      , size_t p_cost
+                                      , const t_error_getter & p_get_errors
+                                      ) const
     {
-        m_file << "<table border=1>" << std::endl;
-        m_file << "<tr>" << std::endl;
-        m_file << "<th>Ip</th>" << std::endl;
-        m_file << "<th>Object</th>" << std::endl;
-        m_file << "<th>Function</th>" << std::endl;
-        m_file << "<th>Directory</th>" << std::endl;
-        m_file << "<th>File</th>" << std::endl;
-        m_file << "<th>Line</th>" << std::endl;
-        m_file << "</tr>" << std::endl;
-    }
-
-    //-------------------------------------------------------------------------
-    void
-    html_generator::generate_html_frame_array_end()
-    {
-        m_file << "</table>" << std::endl;
+        size_t l_budget = get_page_budget();
+        std::vector<t_symbol_position> l_bounds(1, t_symbol_position(p_sorted.begin(), 0));
+        size_t l_page_cost = 0;
+        for(t_symbol_iterator l_iter = p_sorted.begin(); l_iter != p_sorted.end(); ++l_iter)
+        {
+            size_t l_error_number = p_get_errors(l_iter->second).size();
+            if(l_page_cost && l_page_cost + p_cost + l_error_number > l_budget)
+            {
+                l_bounds.push_back(t_symbol_position(l_iter, 0));
+                l_page_cost = 0;
+            }
+            size_t l_first = 0;
+            while(p_cost + l_error_number - l_first > l_budget)
+            {
+                l_first += l_budget - p_cost;
+                l_bounds.push_back(t_symbol_position(l_iter, l_first));
+            }
+            l_page_cost += p_cost + l_error_number - l_first;
+        }
+        l_bounds.push_back(t_symbol_position(p_sorted.end(), 0));
+        return l_bounds;
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::generate_html(const valgrind_frame & p_frame)
+    html_generator::seek_page( const std::vector<t_symbol_position> & p_pages
+                             , t_symbol_iterator p_symbol
+                             , size_t & p_page
+                             )
     {
-        m_file << "<tr>" << std::endl;
-        m_file << "<td>" << get_frame_link(p_frame) << "</td>" << std::endl;
-        m_file << "<td>" << (!p_frame.get_obj().empty() ? get_object_link(p_frame.get_obj()) : "") << "</td>" << std::endl;
-        m_file << "<td>" << (!p_frame.get_fn().empty() ? get_function_link(p_frame.get_fn()) : "") << "</td>" << std::endl;
-        m_file << "<td>" << (!p_frame.get_dir().empty() ? get_directory_link(p_frame.get_dir()) : "") << "</td>" << std::endl;
-        m_file << "<td>" << (!p_frame.get_file().empty() ? get_file_link(p_frame.get_file()) : "" )<< "</td>" << std::endl;
-        if(p_frame.get_line())
+        // Pages continuing errors of previous symbols are skipped
+        while(p_pages[p_page + 1].first != p_symbol && p_pages[p_page + 1].second)
         {
-            m_file << "<td>" << p_frame.get_line() << "</td>" << std::endl;
+            ++p_page;
         }
-        else
+        if(p_pages[p_page + 1].first == p_symbol && !p_pages[p_page + 1].second)
         {
-            m_file << "<td></td>" << std::endl;
+            ++p_page;
         }
-        m_file << "</tr>" << std::endl;
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_kind_id(const std::string & p_kind) const
+    size_t
+    html_generator::get_page_budget() const
     {
-        auto l_iter = m_kinds.find(p_kind);
-        assert(m_kinds.end() != l_iter);
-        return "Kind_" + std::to_string(l_iter->second);
+        return m_directory.empty() ? std::numeric_limits<size_t>::max() : m_lines_per_page;
     }
 
     //-------------------------------------------------------------------------
     std::string
-    html_generator::get_kind_link(const std::string & p_kind) const
+    html_generator::get_page_name( const std::string & p_base
+                                 , size_t p_page
+                                 ) const
     {
-        return "<a href=\"#" + get_kind_id(p_kind) + "\">" + p_kind + "</a>";
+        if(m_directory.empty())
+        {
+            return "";
+        }
+        return p_base + "_" + std::to_string(p_page) + ".html";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_file_id(const std::string & p_file) const
+    void
+    html_generator::generate_pages(const std::vector<t_page> & p_pages)
     {
-        auto l_iter = m_files.find(p_file);
-        assert(m_files.end() != l_iter);
-        return "File_" + std::to_string(l_iter->second);
+        // Pages are independent files, each thread writes the next page
+        // not yet taken
+        unsigned int l_thread_number = static_cast<unsigned int>(std::min(static_cast<size_t>(m_jobs), p_pages.size()));
+        std::vector<std::exception_ptr> l_exceptions(l_thread_number);
+        std::atomic<size_t> l_next_page(0);
+        const auto l_work = [&](unsigned int p_thread)
+        {
+            try
+            {
+                for(size_t l_index = l_next_page++; l_index < p_pages.size(); l_index = l_next_page++)
+                {
+                    generate_page(p_pages[l_index]);
+                }
+            }
+            catch(...)
+            {
+                l_exceptions[p_thread] = std::current_exception();
+                l_next_page = p_pages.size();
+            }
+        };
+        std::vector<std::thread> l_threads;
+        for(unsigned int l_thread = 1; l_thread < l_thread_number; ++l_thread)
+        {
+            l_threads.emplace_back(l_work, l_thread);
+        }
+        l_work(0);
+        for(auto & l_iter: l_threads)
+        {
+            l_iter.join();
+        }
+        for(const auto & l_exception: l_exceptions)
+        {
+            if(l_exception)
+            {
+                std::rethrow_exception(l_exception);
+            }
+        }
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_file_link(const std::string & p_kind) const
+    void
+    html_generator::generate_page(const t_page & p_page)
     {
-        return "<a href=\"#" + get_file_id(p_kind) + "\">" + p_kind + "</a>";
+        // Pages are already written in parallel, each one is compressed by
+        // the thread writing it
+        report_file l_file(m_directory + "/" + p_page.first + (m_compressed ? ".gz" : ""), m_compressed);
+        generate_head_html(l_file);
+        p_page.second(l_file);
+        l_file << "</body>\n" << "</html>\n";
+        l_file.close();
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_object_id(const std::string & p_object) const
+    void
+    html_generator::generate_navigation_html( const std::string & p_base
+                                            , size_t p_page
+                                            , size_t p_page_number
+                                            , std::ostream & p_stream
+                                            )
     {
-        auto l_iter = m_objects.find(p_object);
-        assert(m_objects.end() != l_iter);
-        return "Object_" + std::to_string(l_iter->second);
+        p_stream << R"(<p><a href="index.html">Index</a>)";
+        if(p_page)
+        {
+            p_stream << R"( | <a href=")" << get_page_name(p_base, p_page - 1) << R"(">Previous</a>)";
+        }
+        if(p_page + 1 < p_page_number)
+        {
+            p_stream << R"( | <a href=")" << get_page_name(p_base, p_page + 1) << R"(">Next</a>)";
+        }
+        p_stream << " | Page " << p_page + 1 << " of " << p_page_number << "</p>\n";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_object_link(const std::string & p_object) const
+    void
+    html_generator::generate_sections(const std::vector<t_section> & p_sections)
     {
-        return "<a href=\"#" + get_object_id(p_object) + "\">" + p_object + "</a>";
-    }
+        if(m_jobs < 2)
+        {
+            for(const auto & l_section: p_sections)
+            {
+                l_section(*m_file);
+            }
+            return;
+        }
 
-    //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_function_id(const std::string & p_function) const
-    {
-        auto l_iter = m_functions.find(p_function);
-        assert(m_functions.end() != l_iter);
-        return "function_" + std::to_string(l_iter->second);
+        // Workers render sections in their own buffer while this thread
+        // writes buffers in report order. Workers stay a few sections
+        // ahead of the one being written so that report is not held in
+        // memory
+        size_t l_section_number = p_sections.size();
+        size_t l_window = 2 * m_jobs;
+        std::vector<std::unique_ptr<std::ostringstream>> l_buffers(l_section_number);
+        std::vector<std::exception_ptr> l_exceptions(l_section_number);
+        std::vector<bool> l_done(l_section_number, false);
+        size_t l_next_section = 0;
+        size_t l_written_number = 0;
+        std::mutex l_mutex;
+        std::condition_variable l_condition;
+        const auto l_work = [&]()
+        {
+            for(;;)
+            {
+                size_t l_index;
+                {
+                    std::unique_lock<std::mutex> l_lock(l_mutex);
+                    l_condition.wait(l_lock, [&](){return l_next_section >= l_section_number || l_next_section < l_written_number + l_window;});
+                    if(l_next_section >= l_section_number)
+                    {
+                        return;
+                    }
+                    l_index = l_next_section++;
+                }
+                std::unique_ptr<std::ostringstream> l_buffer(new std::ostringstream());
+                try
+                {
+                    p_sections[l_index](*l_buffer);
+                }
+                catch(...)
+                {
+                    l_exceptions[l_index] = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> l_lock(l_mutex);
+                    l_buffers[l_index] = std::move(l_buffer);
+                    l_done[l_index] = true;
+                }
+                l_condition.notify_all();
+            }
+        };
+        std::vector<std::thread> l_threads;
+        for(unsigned int l_index = 0; l_index < m_jobs; ++l_index)
+        {
+            l_threads.emplace_back(l_work);
+        }
+        std::exception_ptr l_exception;
+        for(size_t l_index = 0; l_index < l_section_number && !l_exception; ++l_index)
+        {
+            std::unique_ptr<std::ostringstream> l_buffer;
+            {
+                std::unique_lock<std::mutex> l_lock(l_mutex);
+                l_condition.wait(l_lock, [&](){return l_done[l_index];});
+                l_buffer = std::move(l_buffers[l_index]);
+                l_exception = l_exceptions[l_index];
+                ++l_written_number;
+                if(l_exception)
+                {
+                    // Remaining sections are abandoned
+                    l_next_section = l_section_number;
+                }
+            }
+            l_condition.notify_all();
+            const std::string l_text = l_buffer->str();
+            m_file->write(l_text.data(), l_text.size());
+        }
+        for(auto & l_iter: l_threads)
+        {
+            l_iter.join();
+        }
+        if(l_exception)
+        {
+            std::rethrow_exception(l_exception);
+        }
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_function_link(const std::string & p_function) const
+    void
+    html_generator::generate_head_html(std::ostream & p_stream)
     {
-        return "<a href=\"#" + get_function_id(p_function) + "\">" + p_function + "</a>";
+        std::string l_title = "Valgrind_report";
+        p_stream << "<!DOCTYPE html>\n";
+        p_stream << "<html>\n";
+        p_stream << "<head>\n";
+        p_stream << R"(<meta http-equiv="Content-Type" content="text/html; charset=utf-8">)" << '\n';
+        p_stream << "<title>" << l_title << "</title>\n";
+        p_stream << "</head>\n";
+        p_stream << "<body>\n";
+        p_stream << "<H1>" << l_title << "</H1>\n";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_directory_id(const std::string & p_directory) const
+    void
+    html_generator::generate_summary_list_html(std::ostream & p_stream)
     {
-        auto l_iter = m_directories.find(p_directory);
-        assert(m_directories.end() != l_iter);
-        return "directory_" + std::to_string(l_iter->second);
+        p_stream << "<H2>Summary</H2>\n";
+        p_stream << "<ul>\n";
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_kinds", 0) << R"(#Encountered_Kinds">Encountered Kinds</a></li>)";
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_files", 0) << R"(#Encountered_Files">Encountered Files</a></li>)";
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_objects", 0) << R"(#Encountered_Objects">Encountered Objects</a></li>)";
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_functions", 0) << R"(#Encountered_Functions">Encountered Functions</a></li>)";
+        if(!m_directory.empty())
+        {
+            p_stream << R"(<li><a href=")" << get_page_name("encountered_directories", 0) << R"(#Encountered_Directories">Encountered Directories</a></li>)";
+        }
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_errors", 0) << R"(#Encountered_Errors">Encountered Errors</a></li>)";
+        p_stream << R"(<li><a href=")" << get_page_name("encountered_frames", 0) << R"(#Encountered_Frames">Encountered Frames</a></li>)";
+        if(m_multiple_sources)
+        {
+            p_stream << R"(<li><a href="#Log_Files">Log Files</a></li>)";
+        }
+        if(!m_directory.empty())
+        {
+            // Single file report reaches these sections through links of
+            // lists
+            p_stream << R"(<li><a href=")" << get_page_name("kinds", 0) << R"(">Errors per kind</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("files", 0) << R"(">Errors per files</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("objects", 0) << R"(">Errors per objects</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("functions", 0) << R"(">Errors per functions</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("directories", 0) << R"(">Errors per directories</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("frames", 0) << R"(">Errors per frames</a></li>)";
+            p_stream << R"(<li><a href=")" << get_page_name("errors", 0) << R"(">Errors</a></li>)";
+        }
+        p_stream << "</ul>\n";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_directory_link(const std::string & p_directory) const
+    void
+    html_generator::generate_summary_html(std::ostream & p_stream)
     {
-        return "<a href=\"#" + get_directory_id(p_directory) + "\">" + p_directory + "</a>";
+        generate_head_html(p_stream);
+        generate_summary_list_html(p_stream);
+        const auto l_generate_list = [&]( const std::string & p_id
+                                        , const std::string & p_title
+                                        , const valgrind_symbol_statistics & p_statistics
+                                        , const std::vector<std::string> & p_links
+                                        )
+        {
+            generate_encountered_symbols_html(p_id, p_title, p_links, p_statistics.get_sorted().begin(), p_statistics.get_sorted().end(), p_stream);
+        };
+        l_generate_list("Encountered_Kinds", "Encountered kinds", m_statistics->get_kinds(), m_kind_links);
+        l_generate_list("Encountered_Files", "Encountered files", m_statistics->get_files(), m_file_links);
+        l_generate_list("Encountered_Objects", "Encountered Objects", m_statistics->get_objects(), m_object_links);
+        l_generate_list("Encountered_Functions", "Encountered Functions", m_statistics->get_functions(), m_function_links);
+        l_generate_list("Encountered_Directories", "Encountered Directories", m_statistics->get_directories(), m_directory_links);
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_error_id(const valgrind_error & p_error) const
+    void
+    html_generator::generate_encountered_symbols_html( const std::string & p_id
+                                                     , const std::string & p_title
+                                                     , const std::vector<std::string> & p_links
+                                                     , t_symbol_iterator p_begin
+                                                     , t_symbol_iterator p_end
+                                                     , std::ostream & p_stream
+                                                     )
     {
-        return "Error_" + std::to_string(p_error.get_unique());
+        p_stream << R"(<H2 id=")" << p_id << R"(">)" << p_title << "</H2>\n";
+        p_stream << "<ul>\n";
+        for(t_symbol_iterator l_iter = p_begin; l_iter != p_end; ++l_iter)
+        {
+            assert(l_iter->second < p_links.size());
+            p_stream << "<li>" << p_links[l_iter->second] << " : " << l_iter->first << "</li>\n";
+        }
+        p_stream << "</ul>\n";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_error_link(const valgrind_error & p_error) const
+    void
+    html_generator::generate_encountered_errors_html( const valgrind_log_content & p_content
+                                                    , t_error_iterator p_begin
+                                                    , t_error_iterator p_end
+                                                    , std::ostream & p_stream
+                                                    )
     {
-        return "<a href=\"#" + get_error_id(p_error) + "\">" + std::to_string(p_error.get_unique()) + "</a>";
+        p_stream << R"(<H2 id="Encountered_Errors">Encountered Errors</H2>)" << '\n';
+        p_stream << "<ul>\n";
+        for(t_error_iterator l_iter = p_begin; l_iter != p_end; ++l_iter)
+        {
+
+            p_stream << "<li> Error" << get_error_link(l_iter->second) << "(" << get_kind_link(p_content.get_errors().get_kinds()[l_iter->second]) << ") : " << l_iter->first << "</li>\n";
+        }
+        p_stream << "</ul>\n";
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_frame_id(const valgrind_frame & p_frame) const
+    void
+    html_generator::generate_encountered_frames_html( t_symbol_iterator p_begin
+                                                    , t_symbol_iterator p_end
+                                                    , std::ostream & p_stream
+                                                    )
     {
-        return "frame_" + std::to_string(p_frame.get_ip());
+        p_stream << R"(<H2 id="Encountered_Frames">Encountered Frames</H2>)" << '\n';
+        generate_html_frame_array_start(p_stream);
+        for(t_symbol_iterator l_iter = p_begin; l_iter != p_end; ++l_iter)
+        {
+            generate_frame_html(l_iter->second, p_stream);
+        }
+        generate_html_frame_array_end(p_stream);
     }
 
     //-------------------------------------------------------------------------
-    std::string
-    html_generator::get_frame_link(const valgrind_frame & p_frame) const
+    void
+    html_generator::generate_errors_html( const valgrind_log_content & p_content
+                                        , size_t p_begin
+                                        , size_t p_end
+                                        , std::ostream & p_stream
+                                        )
     {
-        return "<a href=\"#" + get_frame_id(p_frame) + "\">" + std::to_string(p_frame.get_ip()) + "</a>";
+        for(size_t l_index = p_begin; l_index < p_end; ++l_index)
+        {
+            generate_html(l_index, p_content, p_stream);
+        }
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::generate_kinds_html(const valgrind_log_content & p_content)
+    html_generator::generate_html( size_t p_index
+                                 , const valgrind_log_content & p_content
+                                 , std::ostream & p_stream
+                                 )
     {
-        m_file << "<H2>Errors per kind</H2>" << std::endl;
-        for(auto l_iter: m_sorted_kinds)
+        const valgrind_error l_error = p_content.get_errors().get(p_index);
+        p_stream << "<hr id=\"" << get_error_id(p_index) << "\">\n";
+        p_stream << "Error <b>" << get_error_name(p_index) << "</b>\n";
+        p_stream << "<ul>\n";
+        if(m_multiple_sources)
         {
-            bool l_first = true;
-            m_file << "<hr id=\"" << get_kind_id(l_iter.second) << "\">" << std::endl;
-            m_file << "Errors of kind <b>" << l_iter.second << "</b>" << std::endl;
-            const auto l_collecter_errors_per_kind = [&](const valgrind_error & p_error)
+            p_stream << "<li>Log file : <b>" << l_error.get_source().get_name() << "</b></li>\n";
+        }
+        p_stream << "<li>Kind : <b>" << get_kind_link(l_error.get_kind()) << "</b></li>\n";
+        if(!l_error.get_what().empty())
+        {
+            p_stream << "<li>What : <b>" << l_error.get_what() << "</b></li>\n";
+        }
+        if(!l_error.get_aux_what().empty())
+        {
+            p_stream << "<li>Aux What : <b>" << l_error.get_aux_what() << "</b></li>\n";
+        }
+        if(l_error.has_xwhat())
+        {
+            p_stream << "<li>What : <b>" << l_error.get_xwhat().get_text() << "</b></li>\n";
+            p_stream << "<ul>\n";
+            p_stream << "<li>Leaked bytes : <b>" << l_error.get_xwhat().get_leaked_bytes() << "</b></li>\n";
+            p_stream << "<li>Leaked blocks : <b>" << l_error.get_xwhat().get_leaked_blocks() << "</b></li>\n";
+            p_stream << "</ul>\n";
+        }
+        p_stream << "<li>Tid: <b>" << l_error.get_tid() << "</b></li>\n";
+        // A call stack already met is only rendered with its first error
+        uint32_t l_stack_error = m_statistics->get_stack_error(p_index);
+        if(l_stack_error != p_index && l_error.get_stack_size())
+        {
+            p_stream << "<li>Call stack: same as Error " << get_error_link(l_stack_error) << "</li>\n";
+        }
+        else
+        {
+            p_stream << "<li>Call stack:</li>\n";
+
+            generate_html_frame_array_start(p_stream);
+            const uint32_t * l_stack = l_error.get_stack();
+            for(uint32_t l_rank = 0; l_rank < l_error.get_stack_size(); ++l_rank)
             {
-                if(l_iter.second == p_error.get_kind())
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_kind);
-            m_file << "</li></ul>" << std::endl;
+                generate_frame_html(l_stack[l_rank], p_stream);
+            }
+            generate_html_frame_array_end(p_stream);
         }
 
+        p_stream << "</ul>\n";
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::collect_error_info(const valgrind_log_content & p_content)
+    html_generator::generate_html_frame_array_start(std::ostream & p_stream)
     {
-        m_errors.clear();
-        const auto l_collect_errors = [&](const valgrind_error & p_error)
-        {
-            m_errors.insert(std::make_pair(p_error.get_unique(), &p_error));
-        };
-        p_content.process_errors(l_collect_errors);
-
-        m_sorted_errors.clear();
-        const auto l_collect_error_counts = [&](const std::pair<uint64_t, uint32_t> & p_pair)
-        {
-            m_sorted_errors.insert(std::make_pair(p_pair.second, p_pair.first));
-        };
-        p_content.process_error_counts(l_collect_error_counts);
+        p_stream << "<table border=1>\n";
+        p_stream << "<tr>\n";
+        p_stream << "<th>Ip</th>\n";
+        p_stream << "<th>Object</th>\n";
+        p_stream << "<th>Function</th>\n";
+        p_stream << "<th>Directory</th>\n";
+        p_stream << "<th>File</th>\n";
+        p_stream << "<th>Line</th>\n";
+        p_stream << "</tr>\n";
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::collect_kind_info(const valgrind_log_content & p_content)
+    html_generator::generate_html_frame_array_end(std::ostream & p_stream)
     {
-        m_kinds.clear();
-        const auto l_collect_kind = [&](const valgrind_error & p_error)
-        {
-            m_kinds.insert(std::pair<std::string, unsigned int>(p_error.get_kind(), m_kinds.size()));
-        };
-        p_content.process_errors(l_collect_kind);
-
-        /**
-         * Number of occurence per kind
-         */
-        std::map<std::string, unsigned int> l_kind_number;
-        l_kind_number.clear();
-        for(const auto & l_iter: m_kinds)
-        {
-            l_kind_number[l_iter.first] = 0;
-        }
-
-        const auto l_count_kind = [&](const valgrind_error & p_error)
-        {
-            l_kind_number[p_error.get_kind()]++;
-        };
-
-        p_content.process_errors(l_count_kind);
+        p_stream << "</table>\n";
+    }
 
-        m_sorted_kinds.clear();
-        for(const auto & l_iter:l_kind_number)
-        {
-            m_sorted_kinds.insert(std::pair<unsigned int, std::string>(l_iter.second, l_iter.first));
-        }
+    //-------------------------------------------------------------------------
+    void
+    html_generator::generate_frame_html( uint32_t p_frame
+                                       , std::ostream & p_stream
+                                       )
+    {
+        assert(p_frame < m_frame_rows.size());
+        p_stream << m_frame_rows[p_frame];
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::collect_file_info(const valgrind_log_content & p_content)
+    html_generator::prepare_markup(const valgrind_log_content & p_content)
     {
-        m_files.clear();
-        std::map<std::string, unsigned int> l_file_number;
-        l_file_number.clear();
-        const auto l_collected_files_from_frame = [&](const valgrind_frame & p_frame)
+        uint32_t l_symbol_number = p_content.get_symbol_number();
+        // Links target the page holding the anchor in "Errors per"
+        // sections
+        const auto l_prepare_symbols = [&]( const valgrind_symbol_statistics & p_statistics
+                                          , const std::string & p_prefix
+                                          , const std::vector<t_symbol_position> & p_pages
+                                          , const std::string & p_page_base
+                                          , std::vector<std::string> & p_ids
+                                          , std::vector<std::string> & p_links
+                                          )
         {
-            const std::string & l_file_name = p_frame.get_file();
-            if(!l_file_name.empty())
+            p_ids.assign(l_symbol_number, std::string());
+            p_links.assign(l_symbol_number, std::string());
+            size_t l_page = 0;
+            std::string l_page_name = get_page_name(p_page_base, l_page);
+            for(t_symbol_iterator l_iter = p_statistics.get_sorted().begin(); l_iter != p_statistics.get_sorted().end(); ++l_iter)
             {
-                m_files.insert(std::pair<std::string, unsigned int>(l_file_name, m_files.size()));
-                auto l_counter_iter = l_file_number.find(l_file_name);
-                if(l_file_number.end() == l_counter_iter)
-                {
-                    l_file_number.insert(make_pair(l_file_name, 1));
-                }
-                else
+                size_t l_previous_page = l_page;
+                seek_page(p_pages, l_iter, l_page);
+                if(l_page != l_previous_page)
                 {
-                    ++(l_counter_iter->second);
+                    l_page_name = get_page_name(p_page_base, l_page);
                 }
+                uint32_t l_symbol = l_iter->second;
+                p_ids[l_symbol] = p_prefix + std::to_string(p_statistics.get_number(l_symbol));
+                p_links[l_symbol] = "<a href=\"" + l_page_name + "#" + p_ids[l_symbol] + "\">" + p_content.get_symbol(l_symbol) + "</a>";
             }
         };
-
-        const auto l_collect_files_from_error = [&](const valgrind_error & p_error)
+        l_prepare_symbols(m_statistics->get_kinds(), "Kind_", m_kind_pages, "kinds", m_kind_ids, m_kind_links);
+        l_prepare_symbols(m_statistics->get_files(), "File_", m_file_pages, "files", m_file_ids, m_file_links);
+        l_prepare_symbols(m_statistics->get_objects(), "Object_", m_object_pages, "objects", m_object_ids, m_object_links);
+        l_prepare_symbols(m_statistics->get_functions(), "function_", m_function_pages, "functions", m_function_ids, m_function_links);
+        l_prepare_symbols(m_statistics->get_directories(), "directory_", m_directory_pages, "directories", m_directory_ids, m_directory_links);
+
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        const std::vector<const valgrind_log_source *> & l_sources = l_errors.get_sources();
+        const std::vector<uint64_t> & l_uniques = l_errors.get_uniques();
+        m_error_ids.resize(l_errors.get_size());
+        m_error_names.resize(l_errors.get_size());
+        m_error_links.resize(l_errors.get_size());
+        size_t l_error_page = 0;
+        std::string l_error_page_name = get_page_name("errors", l_error_page);
+        for(size_t l_index = 0; l_index < l_errors.get_size(); ++l_index)
         {
-            p_error.process_stack(l_collected_files_from_frame);
-        };
-        p_content.process_errors(l_collect_files_from_error);
+            while(l_index == m_error_pages[l_error_page + 1])
+            {
+                l_error_page_name = get_page_name("errors", ++l_error_page);
+            }
+            std::string l_unique = std::to_string(l_uniques[l_index]);
+            if(m_multiple_sources)
+            {
+                m_error_ids[l_index] = "Error_" + std::to_string(l_sources[l_index]->get_index()) + "_" + l_unique;
+                m_error_names[l_index] = std::to_string(l_sources[l_index]->get_pid()) + ":" + l_unique;
+            }
+            else
+            {
+                m_error_ids[l_index] = "Error_" + l_unique;
+                m_error_names[l_index] = l_unique;
+            }
+            m_error_links[l_index] = "<a href=\"" + l_error_page_name + "#" + m_error_ids[l_index] + "\">" + m_error_names[l_index] + "</a>";
+        }
 
-        m_sorted_files.clear();
-        for(const auto & l_iter:l_file_number)
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+        m_frame_ids.resize(l_frames.get_size());
+        m_frame_rows.resize(l_frames.get_size());
+        // Frames sharing an instruction pointer share the anchor of the
+        // first of them
+        std::unordered_map<uint64_t, std::string> l_ip_page_names;
+        if(!m_directory.empty())
         {
-            m_sorted_files.insert(std::pair<unsigned int, std::string>(l_iter.second, l_iter.first));
+            size_t l_frame_page = 0;
+            for(t_symbol_iterator l_iter = m_statistics->get_sorted_frames().begin(); l_iter != m_statistics->get_sorted_frames().end(); ++l_iter)
+            {
+                seek_page(m_frame_pages, l_iter, l_frame_page);
+                l_ip_page_names[l_frames.get(l_iter->second).get_ip()] = get_page_name("frames", l_frame_page);
+            }
+        }
+        for(uint32_t l_index = 0; l_index < l_frames.get_size(); ++l_index)
+        {
+            const valgrind_frame & l_frame = l_frames.get(l_index);
+            std::string l_ip = std::to_string(l_frame.get_ip());
+            m_frame_ids[l_index] = "frame_" + l_ip;
+            std::string & l_row = m_frame_rows[l_index];
+            l_row = "<tr>\n";
+            l_row += "<td><a href=\"" + (m_directory.empty() ? "" : l_ip_page_names[l_frame.get_ip()]) + "#" + m_frame_ids[l_index] + "\">" + l_ip + "</a></td>\n";
+            l_row += "<td>" + (l_frame.get_obj() ? m_object_links[l_frame.get_obj()] : "") + "</td>\n";
+            l_row += "<td>" + (l_frame.get_fn() ? m_function_links[l_frame.get_fn()] : "") + "</td>\n";
+            l_row += "<td>" + (l_frame.get_dir() ? m_directory_links[l_frame.get_dir()] : "") + "</td>\n";
+            l_row += "<td>" + (l_frame.get_file() ? m_file_links[l_frame.get_file()] : "") + "</td>\n";
+            l_row += "<td>" + (l_frame.get_line() ? std::to_string(l_frame.get_line()) : "") + "</td>\n";
+            l_row += "</tr>\n";
         }
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::generate_files_html(const valgrind_log_content & p_content)
+    const std::string &
+    html_generator::get_kind_id(uint32_t p_kind) const
     {
-        m_file << "<H2>Errors per files</H2>" << std::endl;
-        for(auto l_iter: m_sorted_files)
-        {
-            bool l_first = true;
-            m_file << "<hr id=\"" << get_file_id(l_iter.second) << "\">" << std::endl;
-            m_file << "Errors whose call stack mention file <b>" << l_iter.second << "</b>" << std::endl;
-
-            bool l_contain = false;
-            const auto l_frame_contain_file = [&](const valgrind_frame & p_frame)
-            {
-                if(l_iter.second == p_frame.get_file())
-                {
-                    l_contain = true;
-                }
-            };
-            const auto l_collecter_errors_per_file = [&](const valgrind_error & p_error)
-            {
-                l_contain = false;
-                p_error.process_stack(l_frame_contain_file);
-                if(l_contain)
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_file);
-            m_file << "</li></ul>" << std::endl;
-        }
+        assert(p_kind < m_kind_ids.size());
+        return m_kind_ids[p_kind];
+    }
 
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_kind_link(uint32_t p_kind) const
+    {
+        assert(p_kind < m_kind_links.size());
+        return m_kind_links[p_kind];
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::collect_object_info(const valgrind_log_content & p_content)
+    const std::string &
+    html_generator::get_file_id(uint32_t p_file) const
     {
-        // List all objects
-        m_objects.clear();
-        std::map<std::string, unsigned int> l_object_number;
-        l_object_number.clear();
-        const auto l_collected_objects_from_frame = [&](const valgrind_frame & p_frame)
-        {
-            const std::string & l_object_name = p_frame.get_obj();
-            if(!l_object_name.empty() && !m_objects.count(l_object_name))
-            {
-                m_objects.insert(std::pair<std::string, unsigned int>(l_object_name, m_objects.size()));
-                l_object_number.insert(make_pair(l_object_name, 0));
-            }
-        };
+        assert(p_file < m_file_ids.size());
+        return m_file_ids[p_file];
+    }
 
-        const auto l_collect_objects_from_error = [&](const valgrind_error & p_error)
-        {
-            p_error.process_stack(l_collected_objects_from_frame);
-        };
-        p_content.process_errors(l_collect_objects_from_error);
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_file_link(uint32_t p_file) const
+    {
+        assert(p_file < m_file_links.size());
+        return m_file_links[p_file];
+    }
 
-        // Count objects (once per error)
-        for(auto l_iter: m_objects)
-        {
-            const auto l_count_object_in_errors = [&](const valgrind_error & p_error)
-            {
-                bool l_appear_in_error_stack = false;
-                const auto l_search_objects_in_frame = [&](const valgrind_frame & p_frame)
-                {
-                    if (l_iter.first == p_frame.get_obj())
-                    {
-                        l_appear_in_error_stack = true;
-                    }
-                };
-                p_error.process_stack(l_search_objects_in_frame);
-                if(l_appear_in_error_stack)
-                {
-                    l_object_number[l_iter.first]++;
-                }
-            };
-            p_content.process_errors(l_count_object_in_errors);
-        }
-        m_sorted_objects.clear();
-        for(const auto & l_iter:l_object_number)
-        {
-            m_sorted_objects.insert(std::pair<unsigned int, std::string>(l_iter.second, l_iter.first));
-        }
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_object_id(uint32_t p_object) const
+    {
+        assert(p_object < m_object_ids.size());
+        return m_object_ids[p_object];
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::generate_objects_html(const valgrind_log_content & p_content)
+    const std::string &
+    html_generator::get_object_link(uint32_t p_object) const
     {
-        m_file << "<H2>Errors per objects</H2>" << std::endl;
-        for(const auto & l_iter: m_sorted_objects)
-        {
-            bool l_first = true;
-            const std::string & l_object_name = l_iter.second;
-            m_file << "<hr id=\"" << get_object_id(l_object_name) << "\">" << std::endl;
-            m_file << "Errors whose call stack mention object <b>" << l_object_name << "</b>" << std::endl;
+        assert(p_object < m_object_links.size());
+        return m_object_links[p_object];
+    }
 
-            bool l_contain = false;
-            const auto l_frame_contain_object = [&](const valgrind_frame & p_frame)
-            {
-                if(l_object_name == p_frame.get_obj())
-                {
-                    l_contain = true;
-                }
-            };
-            const auto l_collecter_errors_per_object = [&](const valgrind_error & p_error)
-            {
-                l_contain = false;
-                p_error.process_stack(l_frame_contain_object);
-                if(l_contain)
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_object);
-            m_file << "</li></ul>" << std::endl;
-        }
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_function_id(uint32_t p_function) const
+    {
+        assert(p_function < m_function_ids.size());
+        return m_function_ids[p_function];
+    }
 
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_function_link(uint32_t p_function) const
+    {
+        assert(p_function < m_function_links.size());
+        return m_function_links[p_function];
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::collect_function_info(const valgrind_log_content & p_content)
+    const std::string &
+    html_generator::get_directory_id(uint32_t p_directory) const
     {
-        // List all functions
-        m_functions.clear();
-        std::map<std::string, unsigned int> l_function_number;
-        l_function_number.clear();
-        const auto l_collected_functions_from_frame = [&](const valgrind_frame & p_frame)
-        {
-            const std::string & l_function_name = p_frame.get_fn();
-            if(!l_function_name.empty() && !m_functions.count(l_function_name))
-            {
-                m_functions.insert(std::pair<std::string, unsigned int>(l_function_name, m_functions.size()));
-                l_function_number.insert(make_pair(l_function_name, 0));
-            }
-        };
+        assert(p_directory < m_directory_ids.size());
+        return m_directory_ids[p_directory];
+    }
 
-        const auto l_collect_functions_from_error = [&](const valgrind_error & p_error)
-        {
-            p_error.process_stack(l_collected_functions_from_frame);
-        };
-        p_content.process_errors(l_collect_functions_from_error);
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_directory_link(uint32_t p_directory) const
+    {
+        assert(p_directory < m_directory_links.size());
+        return m_directory_links[p_directory];
+    }
 
-        // Count functions (once per error)
-        for(auto l_iter: m_functions)
-        {
-            const auto l_count_function_in_errors = [&](const valgrind_error & p_error)
-            {
-                bool l_appear_in_error_stack = false;
-                const auto l_search_functions_in_frame = [&](const valgrind_frame & p_frame)
-                {
-                    if (l_iter.first == p_frame.get_fn())
-                    {
-                        l_appear_in_error_stack = true;
-                    }
-                };
-                p_error.process_stack(l_search_functions_in_frame);
-                if(l_appear_in_error_stack)
-                {
-                    l_function_number[l_iter.first]++;
-                }
-            };
-            p_content.process_errors(l_count_function_in_errors);
-        }
-        m_sorted_functions.clear();
-        for(const auto & l_iter:l_function_number)
-        {
-            m_sorted_functions.insert(std::pair<unsigned int, std::string>(l_iter.second, l_iter.first));
-        }
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_frame_id(uint32_t p_frame) const
+    {
+        assert(p_frame < m_frame_ids.size());
+        return m_frame_ids[p_frame];
     }
 
     //-------------------------------------------------------------------------
-    void
-    html_generator::generate_functions_html(const valgrind_log_content & p_content)
+    const std::string &
+    html_generator::get_error_id(size_t p_error) const
     {
-        m_file << "<H2>Errors per functions</H2>" << std::endl;
-        for(const auto & l_iter: m_sorted_functions)
-        {
-            bool l_first = true;
-            const std::string & l_function_name = l_iter.second;
-            m_file << "<hr id=\"" << get_function_id(l_function_name) << "\">" << std::endl;
-            m_file << "Errors whose call stack mention function <b>" << l_function_name << "</b>" << std::endl;
+        assert(p_error < m_error_ids.size());
+        return m_error_ids[p_error];
+    }
 
-            bool l_contain = false;
-            const auto l_frame_contain_function = [&](const valgrind_frame & p_frame)
-            {
-                if(l_function_name == p_frame.get_fn())
-                {
-                    l_contain = true;
-                }
-            };
-            const auto l_collecter_errors_per_function = [&](const valgrind_error & p_error)
-            {
-                l_contain = false;
-                p_error.process_stack(l_frame_contain_function);
-                if(l_contain)
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_function);
-            m_file << "</li></ul>" << std::endl;
-        }
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_error_name(size_t p_error) const
+    {
+        assert(p_error < m_error_names.size());
+        return m_error_names[p_error];
+    }
 
+    //-------------------------------------------------------------------------
+    const std::string &
+    html_generator::get_error_link(size_t p_error) const
+    {
+        assert(p_error < m_error_links.size());
+        return m_error_links[p_error];
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::collect_directory_info(const valgrind_log_content & p_content)
+    html_generator::generate_error_links( const std::vector<uint32_t> & p_errors
+                                        , size_t p_begin
+                                        , size_t p_end
+                                        , std::ostream & p_stream
+                                        )
     {
-        // List all directories
-        m_directories.clear();
-        std::map<std::string, unsigned int> l_directory_number;
-        l_directory_number.clear();
-        const auto l_collected_directories_from_frame = [&](const valgrind_frame & p_frame)
+        p_stream << "<ul><li>\n";
+        for(size_t l_rank = p_begin; l_rank < p_end; ++l_rank)
         {
-            const std::string & l_directory_name = p_frame.get_dir();
-            if(!l_directory_name.empty() && !m_directories.count(l_directory_name))
+            if(l_rank != p_begin)
             {
-                m_directories.insert(std::pair<std::string, unsigned int>(l_directory_name, m_directories.size()));
-                l_directory_number.insert(make_pair(l_directory_name, 0));
+                p_stream << ", ";
             }
-        };
-
-        const auto l_collect_directories_from_error = [&](const valgrind_error & p_error)
-        {
-            p_error.process_stack(l_collected_directories_from_frame);
-        };
-        p_content.process_errors(l_collect_directories_from_error);
-
-        // Count directories (once per error)
-        for(auto l_iter: m_directories)
-        {
-            const auto l_count_directory_in_errors = [&](const valgrind_error & p_error)
-            {
-                bool l_appear_in_error_stack = false;
-                const auto l_search_directories_in_frame = [&](const valgrind_frame & p_frame)
-                {
-                    if (l_iter.first == p_frame.get_dir())
-                    {
-                        l_appear_in_error_stack = true;
-                    }
-                };
-                p_error.process_stack(l_search_directories_in_frame);
-                if(l_appear_in_error_stack)
-                {
-                    l_directory_number[l_iter.first]++;
-                }
-            };
-            p_content.process_errors(l_count_directory_in_errors);
-        }
-        m_sorted_directories.clear();
-        for(const auto & l_iter:l_directory_number)
-        {
-            m_sorted_directories.insert(std::pair<unsigned int, std::string>(l_iter.second, l_iter.first));
+            p_stream << get_error_link(p_errors[l_rank]);
         }
+        p_stream << "</li></ul>\n";
     }
 
     //-------------------------------------------------------------------------
+    template <typename FUNCTION>
     void
-    html_generator::generate_directories_html(const valgrind_log_content & p_content)
+    html_generator::process_positions( t_symbol_position p_begin
+                                     , t_symbol_position p_end
+                                     , const t_error_getter & p_get_errors
+                                     , const FUNCTION & p_function
+                                     ) const
     {
-        m_file << "<H2>Errors per directories</H2>" << std::endl;
-        for(const auto & l_iter: m_sorted_directories)
+        for(t_symbol_iterator l_iter = p_begin.first; ; ++l_iter)
         {
-            bool l_first = true;
-            const std::string & l_directory_name = l_iter.second;
-            m_file << "<hr id=\"" << get_directory_id(l_directory_name) << "\">" << std::endl;
-            m_file << "Errors whose call stack mention directory <b>" << l_directory_name << "</b>" << std::endl;
-
-            bool l_contain = false;
-            const auto l_frame_contain_directory = [&](const valgrind_frame & p_frame)
+            size_t l_first = l_iter == p_begin.first ? p_begin.second : 0;
+            if(l_iter == p_end.first)
             {
-                if(l_directory_name == p_frame.get_dir())
+                if(l_first < p_end.second)
                 {
-                    l_contain = true;
+                    p_function(l_iter, l_first, p_end.second);
                 }
-            };
-            const auto l_collecter_errors_per_directory = [&](const valgrind_error & p_error)
-            {
-                l_contain = false;
-                p_error.process_stack(l_frame_contain_directory);
-                if(l_contain)
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_directory);
-            m_file << "</li></ul>" << std::endl;
+                return;
+            }
+            p_function(l_iter, l_first, p_get_errors(l_iter->second).size());
         }
-
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::collect_frame_info(const valgrind_log_content & p_content)
+    html_generator::generate_symbol_errors_html( const std::string & p_title
+                                               , const std::string & p_description
+                                               , const std::vector<std::string> & p_ids
+                                               , const valgrind_symbol_statistics & p_statistics
+                                               , t_symbol_position p_begin
+                                               , t_symbol_position p_end
+                                               , std::ostream & p_stream
+                                               )
     {
-        // List all frames
-        m_frames.clear();
-        std::map<const valgrind_frame *, unsigned int> l_frame_number;
-        l_frame_number.clear();
-        const auto l_collected_frames_from_frame = [&](const valgrind_frame & p_frame)
+        const t_error_getter l_get_errors = [&](uint32_t p_symbol) -> const std::vector<uint32_t> &
         {
-            const uint64_t & l_frame_ip = p_frame.get_ip();
-            if(!m_frames.count(l_frame_ip))
+            return p_statistics.get_errors(p_symbol);
+        };
+        const auto l_generate_symbol = [&]( t_symbol_iterator p_iter
+                                          , size_t p_first
+                                          , size_t p_last
+                                          )
+        {
+            uint32_t l_symbol = p_iter->second;
+            assert(l_symbol < p_ids.size());
+            if(p_first)
+            {
+                p_stream << "<hr>\n";
+                p_stream << p_description << " <b>" << m_content->get_symbol(l_symbol) << "</b> (continued)\n";
+            }
+            else
             {
-                m_frames.insert(std::pair<uint64_t, const valgrind_frame *>(l_frame_ip, &p_frame));
-                l_frame_number.insert(std::make_pair(&p_frame, 0));
+                p_stream << "<hr id=\"" << p_ids[l_symbol] << "\">\n";
+                p_stream << p_description << " <b>" << m_content->get_symbol(l_symbol) << "</b>\n";
             }
+            generate_error_links(p_statistics.get_errors(l_symbol), p_first, p_last, p_stream);
         };
+        p_stream << "<H2>" << p_title << "</H2>\n";
+        process_positions(p_begin, p_end, l_get_errors, l_generate_symbol);
+    }
 
-        const auto l_collect_frames_from_error = [&](const valgrind_error & p_error)
+    //-------------------------------------------------------------------------
+    void
+    html_generator::generate_sources_html( const valgrind_log_content & p_content
+                                         , std::ostream & p_stream
+                                         )
+    {
+        p_stream << R"(<H2 id="Log_Files">Log files</H2>)" << '\n';
+        p_stream << "<table border=1>\n";
+        p_stream << "<tr>\n";
+        p_stream << "<th>Log file</th>\n";
+        p_stream << "<th>Pid</th>\n";
+        p_stream << "<th>Errors</th>\n";
+        p_stream << "</tr>\n";
+        const auto l_treat_source = [&](const valgrind_log_source & p_source)
         {
-            p_error.process_stack(l_collected_frames_from_frame);
+            p_stream << "<tr>\n";
+            p_stream << "<td>" << p_source.get_name() << "</td>\n";
+            p_stream << "<td>" << p_source.get_pid() << "</td>\n";
+            p_stream << "<td>" << m_statistics->get_error_number(p_source) << "</td>\n";
+            p_stream << "</tr>\n";
         };
-        p_content.process_errors(l_collect_frames_from_error);
-
-        // Count frames (once per error)
-        for(auto l_iter: m_frames)
-        {
-            const auto l_count_frames_in_errors = [&](const valgrind_error & p_error)
-            {
-                bool l_appear_in_error_stack = false;
-                const auto l_search_frames_in_frame = [&](const valgrind_frame & p_frame)
-                {
-                    if (l_iter.first == p_frame.get_ip())
-                    {
-                        l_appear_in_error_stack = true;
-                    }
-                };
-                p_error.process_stack(l_search_frames_in_frame);
-                if(l_appear_in_error_stack)
-                {
-                    l_frame_number[l_iter.second]++;
-                }
-            };
-            p_content.process_errors(l_count_frames_in_errors);
-        }
-        m_sorted_frames.clear();
-        for(const auto & l_iter:l_frame_number)
-        {
-            m_sorted_frames.insert(std::make_pair(l_iter.second, l_iter.first));
-        }
+        p_content.process_sources(l_treat_source);
+        p_stream << "</table>\n";
     }
 
     //-------------------------------------------------------------------------
     void
-    html_generator::generate_frames_html(const valgrind_log_content & p_content)
+    html_generator::generate_frames_html( const valgrind_log_content & p_content
+                                        , t_symbol_position p_begin
+                                        , t_symbol_position p_end
+                                        , std::ostream & p_stream
+                                        )
     {
-        m_file << "<H2>Errors per frames</H2>" << std::endl;
-        for(const auto & l_iter: m_sorted_frames)
+        const t_error_getter l_get_errors = [&](uint32_t p_frame) -> const std::vector<uint32_t> &
         {
-            bool l_first = true;
-            const uint64_t l_frame_ip = l_iter.second->get_ip();
-            m_file << "<hr id=\"" << get_frame_id(*l_iter.second) << "\">" << std::endl;
-            m_file << "Errors whose call stack mention Frame <b>" << l_frame_ip << "</b>" << std::endl;
-
-            generate_html_frame_array_start();
-            generate_html(*l_iter.second);
-            generate_html_frame_array_end();
-
-            bool l_contain = false;
-            const auto l_is_searched_frame = [&](const valgrind_frame & p_frame)
+            return m_statistics->get_frame_errors(p_frame);
+        };
+        const auto l_generate_frame = [&]( t_symbol_iterator p_iter
+                                         , size_t p_first
+                                         , size_t p_last
+                                         )
+        {
+            const valgrind_frame & l_frame = p_content.get_frames().get(p_iter->second);
+            if(p_first)
             {
-                if(l_frame_ip == p_frame.get_ip())
-                {
-                    l_contain = true;
-                }
-            };
-            const auto l_collecter_errors_per_frame = [&](const valgrind_error & p_error)
+                p_stream << "<hr>\n";
+                p_stream << "Errors whose call stack mention Frame <b>" << l_frame.get_ip() << "</b> (continued)\n";
+            }
+            else
             {
-                l_contain = false;
-                p_error.process_stack(l_is_searched_frame);
-                if(l_contain)
-                {
-                    if(!l_first)
-                    {
-                        m_file << ", ";
-                    }
-                    else
-                    {
-                        l_first = false;
-                    }
-                    m_file << get_error_link(p_error);
-                }
-            };
-            m_file << "<ul><li>" << std::endl;
-            p_content.process_errors(l_collecter_errors_per_frame);
-            m_file << "</li></ul>" << std::endl;
-        }
+                p_stream << "<hr id=\"" << get_frame_id(p_iter->second) << "\">\n";
+                p_stream << "Errors whose call stack mention Frame <b>" << l_frame.get_ip() << "</b>\n";
+            }
+
+            generate_html_frame_array_start(p_stream);
+            generate_frame_html(p_iter->second, p_stream);
+            generate_html_frame_array_end(p_stream);
 
+            generate_error_links(m_statistics->get_frame_errors(p_iter->second), p_first, p_last, p_stream);
+        };
+        p_stream << "<H2>Errors per frames</H2>\n";
+        process_positions(p_begin, p_end, l_get_errors, l_generate_frame);
     }
 
 
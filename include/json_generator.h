@@ -0,0 +1,240 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_JSON_GENERATOR_H
+#define VALGRIND_LOG_TOOL_JSON_GENERATOR_H
+
+#include "report_generator.h"
+#include "report_file.h"
+#include "string_ref.h"
+#include <ostream>
+#include <string>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Write report as a JSON document to be read by other tools. Document
+     * is written while content is traversed, errors and frames being
+     * written one per line
+     */
+    class json_generator: public report_generator
+    {
+      public:
+
+        /**
+         * @param p_output_file_name name of report file
+         * @param p_jobs number of threads compressing report
+         * @param p_compressed true to write report compressed with gzip
+         */
+        inline explicit
+        json_generator( const std::string & p_output_file_name
+                      , unsigned int p_jobs = 1
+                      , bool p_compressed = false
+                      );
+
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
+        inline
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) override;
+
+        /**
+         * Write a JSON string. Besides JSON escapes, "<" is escaped so that
+         * string can be embedded in a script element
+         */
+        inline static
+        void write_string( std::ostream & p_stream
+                         , const string_ref & p_string
+                         );
+
+      private:
+
+        /**
+         * Write symbols of a statistics in its ranking order with their
+         * number of mentions, which is the ranking key, and their number of
+         * errors, where an error mentioning a symbol in several frames
+         * counts once
+         */
+        inline
+        void generate_symbols( const std::string & p_name
+                             , const valgrind_log_content & p_content
+                             , const valgrind_symbol_statistics & p_statistics
+                             );
+
+        report_file m_file;
+    };
+
+    //-------------------------------------------------------------------------
+    json_generator::json_generator( const std::string & p_output_file_name
+                                  , unsigned int p_jobs
+                                  , bool p_compressed
+                                  )
+    : m_file(p_output_file_name, p_compressed, p_jobs)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    json_generator::generate( const valgrind_log_content & p_content
+                            , const valgrind_log_statistics & p_statistics
+                            )
+    {
+        m_file << "{\"sources\":[";
+        bool l_first = true;
+        const auto l_write_source = [&](const valgrind_log_source & p_source)
+        {
+            m_file << (l_first ? "\n" : ",\n");
+            l_first = false;
+            m_file << "{\"name\":";
+            write_string(m_file, p_source.get_name());
+            m_file << ",\"pid\":" << p_source.get_pid() << ",\"errors\":" << p_statistics.get_error_number(p_source) << '}';
+        };
+        p_content.process_sources(l_write_source);
+        m_file << "],\n";
+        m_file << "\"errorNumber\":" << p_content.get_error_number() << ",\"stackNumber\":" << p_statistics.get_stack_number() << ",\n";
+
+        generate_symbols("kinds", p_content, p_statistics.get_kinds());
+        generate_symbols("files", p_content, p_statistics.get_files());
+        generate_symbols("objects", p_content, p_statistics.get_objects());
+        generate_symbols("functions", p_content, p_statistics.get_functions());
+        generate_symbols("directories", p_content, p_statistics.get_directories());
+
+        // Frames are written in frame table order, stacks of errors refer
+        // to their index
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+        m_file << "\"frames\":[";
+        for(uint32_t l_index = 0; l_index < l_frames.get_size(); ++l_index)
+        {
+            const valgrind_frame & l_frame = l_frames.get(l_index);
+            m_file << (l_index ? ",\n" : "\n");
+            m_file << "{\"ip\":" << l_frame.get_ip() << ",\"object\":";
+            write_string(m_file, p_content.get_symbol(l_frame.get_obj()));
+            m_file << ",\"function\":";
+            write_string(m_file, p_content.get_symbol(l_frame.get_fn()));
+            m_file << ",\"directory\":";
+            write_string(m_file, p_content.get_symbol(l_frame.get_dir()));
+            m_file << ",\"file\":";
+            write_string(m_file, p_content.get_symbol(l_frame.get_file()));
+            m_file << ",\"line\":" << l_frame.get_line() << '}';
+        }
+        m_file << "],\n";
+
+        m_file << "\"frameErrors\":[";
+        l_first = true;
+        for(const auto & l_iter: p_statistics.get_sorted_frames())
+        {
+            m_file << (l_first ? "\n" : ",\n");
+            l_first = false;
+            m_file << "{\"frame\":" << l_iter.second << ",\"errors\":" << l_iter.first << '}';
+        }
+        m_file << "],\n";
+
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        m_file << "\"errors\":[";
+        for(size_t l_index = 0; l_index < l_errors.get_size(); ++l_index)
+        {
+            const valgrind_error l_error = l_errors.get(l_index);
+            m_file << (l_index ? ",\n" : "\n");
+            m_file << "{\"source\":" << l_error.get_source().get_index() << ",\"unique\":" << l_error.get_unique() << ",\"tid\":" << l_error.get_tid() << ",\"kind\":";
+            write_string(m_file, p_content.get_symbol(l_error.get_kind()));
+            m_file << ",\"what\":";
+            write_string(m_file, l_error.get_what());
+            m_file << ",\"auxWhat\":";
+            write_string(m_file, l_error.get_aux_what());
+            if(l_error.has_xwhat())
+            {
+                m_file << ",\"xwhat\":{\"text\":";
+                write_string(m_file, l_error.get_xwhat().get_text());
+                m_file << ",\"leakedBytes\":" << l_error.get_xwhat().get_leaked_bytes() << ",\"leakedBlocks\":" << l_error.get_xwhat().get_leaked_blocks() << '}';
+            }
+            m_file << ",\"stack\":[";
+            const uint32_t * l_stack = l_error.get_stack();
+            for(uint32_t l_rank = 0; l_rank < l_error.get_stack_size(); ++l_rank)
+            {
+                if(l_rank)
+                {
+                    m_file << ',';
+                }
+                m_file << l_stack[l_rank];
+            }
+            m_file << "],\"sameStackAs\":" << p_statistics.get_stack_error(l_index) << '}';
+        }
+        m_file << "]}\n";
+
+        m_file.close();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    json_generator::generate_symbols( const std::string & p_name
+                                    , const valgrind_log_content & p_content
+                                    , const valgrind_symbol_statistics & p_statistics
+                                    )
+    {
+        m_file << '"' << p_name << "\":[";
+        bool l_first = true;
+        for(const auto & l_iter: p_statistics.get_sorted())
+        {
+            m_file << (l_first ? "\n" : ",\n");
+            l_first = false;
+            m_file << "{\"name\":";
+            write_string(m_file, p_content.get_symbol(l_iter.second));
+            m_file << ",\"mentions\":" << l_iter.first << ",\"errors\":" << p_statistics.get_errors(l_iter.second).size() << '}';
+        }
+        m_file << "],\n";
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    json_generator::write_string( std::ostream & p_stream
+                                , const string_ref & p_string
+                                )
+    {
+        static const char * const l_digits = "0123456789abcdef";
+        p_stream << '"';
+        const char * l_begin = p_string.begin();
+        for(const char * l_iter = p_string.begin(); l_iter != p_string.end(); ++l_iter)
+        {
+            unsigned char l_char = static_cast<unsigned char>(*l_iter);
+            if(l_char >= 0x20 && '"' != l_char && '\\' != l_char && '<' != l_char)
+            {
+                continue;
+            }
+            p_stream.write(l_begin, l_iter - l_begin);
+            l_begin = l_iter + 1;
+            if('"' == l_char || '\\' == l_char)
+            {
+                p_stream << '\\' << static_cast<char>(l_char);
+            }
+            else
+            {
+                p_stream << "\\u00" << l_digits[l_char >> 4] << l_digits[l_char & 0xF];
+            }
+        }
+        p_stream.write(l_begin, p_string.end() - l_begin);
+        p_stream << '"';
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_JSON_GENERATOR_H
+// EOF
@@ -0,0 +1,122 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_MAPPED_FILE_H
+#define VALGRIND_LOG_TOOL_MAPPED_FILE_H
+
+#include "quicky_exception.h"
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Read only mapping of a whole file in memory
+     */
+    class mapped_file
+    {
+      public:
+
+        inline explicit
+        mapped_file(const std::string & p_file_name);
+
+        mapped_file(const mapped_file &) = delete;
+
+        mapped_file & operator=(const mapped_file &) = delete;
+
+        inline
+        ~mapped_file();
+
+        inline
+        const char * begin() const;
+
+        inline
+        const char * end() const;
+
+      private:
+        const char * m_data;
+        size_t m_size;
+    };
+
+    //-------------------------------------------------------------------------
+    mapped_file::mapped_file(const std::string & p_file_name)
+    : m_data(nullptr)
+    , m_size(0)
+    {
+        int l_fd = open(p_file_name.c_str(), O_RDONLY);
+        if(-1 == l_fd)
+        {
+            throw quicky_exception::quicky_runtime_exception( "File \"" + p_file_name + "\" not found"
+                                                            , __LINE__
+                                                            , __FILE__
+                                                            );
+        }
+        struct stat l_stat;
+        if(-1 == fstat(l_fd, &l_stat))
+        {
+            std::string l_error{strerror(errno)};
+            close(l_fd);
+            throw quicky_exception::quicky_runtime_exception("Unable to stat file \"" + p_file_name + "\" : " + l_error, __LINE__, __FILE__);
+        }
+        m_size = l_stat.st_size;
+        if(m_size)
+        {
+            void * l_address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, l_fd, 0);
+            if(MAP_FAILED == l_address)
+            {
+                std::string l_error{strerror(errno)};
+                close(l_fd);
+                throw quicky_exception::quicky_runtime_exception("Unable to map file \"" + p_file_name + "\" : " + l_error, __LINE__, __FILE__);
+            }
+            madvise(l_address, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char *>(l_address);
+        }
+        close(l_fd);
+    }
+
+    //-------------------------------------------------------------------------
+    mapped_file::~mapped_file()
+    {
+        if(m_data)
+        {
+            munmap(const_cast<char *>(m_data), m_size);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    mapped_file::begin() const
+    {
+        return m_data;
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    mapped_file::end() const
+    {
+        return m_data + m_size;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_MAPPED_FILE_H
+// EOF
@@ -0,0 +1,203 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_MARKDOWN_GENERATOR_H
+#define VALGRIND_LOG_TOOL_MARKDOWN_GENERATOR_H
+
+#include "report_generator.h"
+#include "report_file.h"
+#include "string_ref.h"
+#include <ostream>
+#include <string>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Write report as Markdown tables: logs, number of errors per kind,
+     * file, object, function and directory, and one line per error with
+     * the innermost frame of its call stack. Meant to be posted as is in
+     * a review or a ticket
+     */
+    class markdown_generator: public report_generator
+    {
+      public:
+
+        /**
+         * @param p_output_file_name name of report file
+         * @param p_jobs number of threads compressing report
+         * @param p_compressed true to write report compressed with gzip
+         */
+        inline explicit
+        markdown_generator( const std::string & p_output_file_name
+                          , unsigned int p_jobs = 1
+                          , bool p_compressed = false
+                          );
+
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
+        inline
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) override;
+
+      private:
+
+        /**
+         * Write a table of symbols in ranking order of statistics with
+         * their number of mentions, which is the ranking key, and their
+         * number of errors, where an error mentioning a symbol in several
+         * frames counts once
+         */
+        inline
+        void generate_symbols( const std::string & p_title
+                             , const valgrind_log_content & p_content
+                             , const valgrind_symbol_statistics & p_statistics
+                             );
+
+        /**
+         * Write a table cell, escaping characters having a meaning in
+         * tables and replacing line breaks by spaces
+         */
+        inline
+        void write_cell(const string_ref & p_cell);
+
+        report_file m_file;
+    };
+
+    //-------------------------------------------------------------------------
+    markdown_generator::markdown_generator( const std::string & p_output_file_name
+                                          , unsigned int p_jobs
+                                          , bool p_compressed
+                                          )
+    : m_file(p_output_file_name, p_compressed, p_jobs)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    markdown_generator::generate( const valgrind_log_content & p_content
+                                , const valgrind_log_statistics & p_statistics
+                                )
+    {
+        m_file << "# Valgrind report\n\n";
+        m_file << p_content.get_error_number() << " errors, " << p_statistics.get_stack_number() << " distinct call stacks\n\n";
+
+        m_file << "## Log files\n\n";
+        m_file << "| Log file | Pid | Errors |\n";
+        m_file << "|---|--:|--:|\n";
+        const auto l_write_source = [&](const valgrind_log_source & p_source)
+        {
+            m_file << "| ";
+            write_cell(p_source.get_name());
+            m_file << " | " << p_source.get_pid() << " | " << p_statistics.get_error_number(p_source) << " |\n";
+        };
+        p_content.process_sources(l_write_source);
+
+        generate_symbols("Kinds", p_content, p_statistics.get_kinds());
+        generate_symbols("Files", p_content, p_statistics.get_files());
+        generate_symbols("Objects", p_content, p_statistics.get_objects());
+        generate_symbols("Functions", p_content, p_statistics.get_functions());
+        generate_symbols("Directories", p_content, p_statistics.get_directories());
+
+        m_file << "\n## Errors\n\n";
+        m_file << "| Error | Kind | What | Function | File | Line |\n";
+        m_file << "|---|---|---|---|---|--:|\n";
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+        bool l_multiple_sources = p_content.get_source_number() > 1;
+        for(size_t l_index = 0; l_index < l_errors.get_size(); ++l_index)
+        {
+            const valgrind_error l_error = l_errors.get(l_index);
+            m_file << "| ";
+            if(l_multiple_sources)
+            {
+                m_file << l_error.get_source().get_pid() << ':';
+            }
+            m_file << l_error.get_unique() << " | ";
+            write_cell(p_content.get_symbol(l_error.get_kind()));
+            m_file << " | ";
+            write_cell(l_error.has_xwhat() ? l_error.get_xwhat().get_text() : l_error.get_what());
+            m_file << " | ";
+            if(l_error.get_stack_size())
+            {
+                const valgrind_frame & l_frame = l_frames.get(l_error.get_stack()[0]);
+                write_cell(p_content.get_symbol(l_frame.get_fn()));
+                m_file << " | ";
+                write_cell(p_content.get_symbol(l_frame.get_file()));
+                m_file << " | ";
+                if(l_frame.get_line())
+                {
+                    m_file << l_frame.get_line();
+                }
+                m_file << " |\n";
+            }
+            else
+            {
+                m_file << " | | |\n";
+            }
+        }
+
+        m_file.close();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    markdown_generator::generate_symbols( const std::string & p_title
+                                        , const valgrind_log_content & p_content
+                                        , const valgrind_symbol_statistics & p_statistics
+                                        )
+    {
+        m_file << "\n## " << p_title << "\n\n";
+        m_file << "| Name | Mentions | Errors |\n";
+        m_file << "|---|--:|--:|\n";
+        for(const auto & l_iter: p_statistics.get_sorted())
+        {
+            m_file << "| ";
+            write_cell(p_content.get_symbol(l_iter.second));
+            m_file << " | " << l_iter.first << " | " << p_statistics.get_errors(l_iter.second).size() << " |\n";
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    markdown_generator::write_cell(const string_ref & p_cell)
+    {
+        for(auto l_char: p_cell)
+        {
+            if('|' == l_char || '\\' == l_char || '<' == l_char || '`' == l_char || '*' == l_char || '_' == l_char)
+            {
+                m_file << '\\' << l_char;
+            }
+            else if('\n' == l_char || '\r' == l_char)
+            {
+                m_file << ' ';
+            }
+            else
+            {
+                m_file << l_char;
+            }
+        }
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_MARKDOWN_GENERATOR_H
+// EOF
@@ -0,0 +1,245 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_NUMBER_PARSER_H
+#define VALGRIND_LOG_TOOL_NUMBER_PARSER_H
+
+#include "string_ref.h"
+#include "quicky_exception.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Parse an unsigned number directly from characters without allocation
+     * nor locale. Like strtoull with base 0, a "0x" prefix denotes an
+     * hexadecimal number and a leading 0 an octal one.
+     * An exception is thrown if text is not a number or if number does not
+     * fit in type T
+     * @param p_text text to parse
+     * @return parsed number
+     */
+    template <typename T>
+    inline
+    T parse_number(const string_ref & p_text);
+
+    /**
+     * Parse hexadecimal digits
+     * @param p_begin first digit
+     * @param p_end end of digits
+     * @param p_value parsed value
+     * @return false if a character is not a digit or value overflows
+     */
+    inline
+    bool parse_hexadecimal( const char * p_begin
+                          , const char * p_end
+                          , uint64_t & p_value
+                          );
+
+    /**
+     * Parse decimal digits
+     * @param p_begin first digit
+     * @param p_end end of digits
+     * @param p_value parsed value
+     * @return false if a character is not a digit or value overflows
+     */
+    inline
+    bool parse_decimal( const char * p_begin
+                      , const char * p_end
+                      , uint64_t & p_value
+                      );
+
+    /**
+     * Parse octal digits
+     * @param p_begin first digit
+     * @param p_end end of digits
+     * @param p_value parsed value
+     * @return false if a character is not a digit or value overflows
+     */
+    inline
+    bool parse_octal( const char * p_begin
+                    , const char * p_end
+                    , uint64_t & p_value
+                    );
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    /**
+     * Convert 8 hexadecimal digits at once using 64 bits arithmetic
+     * @param p_digits 8 characters, first one is most significant
+     * @param p_value value of the 8 digits
+     * @return false if a character is not an hexadecimal digit
+     */
+    inline
+    bool parse_8_hexadecimal_digits( const char * p_digits
+                                   , uint32_t & p_value
+                                   );
+#endif // __BYTE_ORDER__
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    T parse_number(const string_ref & p_text)
+    {
+        static_assert(std::is_unsigned<T>::value && sizeof(T) <= sizeof(uint64_t), "Only unsigned types up to 64 bits are supported");
+        const char * l_begin = p_text.begin();
+        const char * l_end = p_text.end();
+        uint64_t l_value = 0;
+        bool l_ok;
+        if(l_end - l_begin > 2 && '0' == l_begin[0] && ('x' == l_begin[1] || 'X' == l_begin[1]))
+        {
+            l_ok = parse_hexadecimal(l_begin + 2, l_end, l_value);
+        }
+        else if(l_end - l_begin > 1 && '0' == l_begin[0])
+        {
+            l_ok = parse_octal(l_begin + 1, l_end, l_value);
+        }
+        else
+        {
+            l_ok = l_begin != l_end && parse_decimal(l_begin, l_end, l_value);
+        }
+        if(!l_ok || l_value > std::numeric_limits<T>::max())
+        {
+            throw quicky_exception::quicky_logic_exception("\"" + p_text.str() + "\" is not a valid " + std::to_string(8 * sizeof(T)) + " bits unsigned number", __LINE__, __FILE__);
+        }
+        return static_cast<T>(l_value);
+    }
+
+    //-------------------------------------------------------------------------
+    bool parse_hexadecimal( const char * p_begin
+                          , const char * p_end
+                          , uint64_t & p_value
+                          )
+    {
+        uint64_t l_value = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        for(; p_end - p_begin >= 8; p_begin += 8)
+        {
+            uint32_t l_chunk;
+            if(l_value >> 32 || !parse_8_hexadecimal_digits(p_begin, l_chunk))
+            {
+                return false;
+            }
+            l_value = (l_value << 32) | l_chunk;
+        }
+#endif // __BYTE_ORDER__
+        for(; p_begin < p_end; ++p_begin)
+        {
+            char l_char = *p_begin;
+            unsigned int l_digit;
+            if('0' <= l_char && l_char <= '9')
+            {
+                l_digit = l_char - '0';
+            }
+            else if('a' <= (l_char | 0x20) && (l_char | 0x20) <= 'f')
+            {
+                l_digit = (l_char | 0x20) - 'a' + 10;
+            }
+            else
+            {
+                return false;
+            }
+            if(l_value >> 60)
+            {
+                return false;
+            }
+            l_value = (l_value << 4) | l_digit;
+        }
+        p_value = l_value;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool parse_decimal( const char * p_begin
+                      , const char * p_end
+                      , uint64_t & p_value
+                      )
+    {
+        uint64_t l_value = 0;
+        for(; p_begin < p_end; ++p_begin)
+        {
+            unsigned int l_digit = static_cast<unsigned char>(*p_begin) - '0';
+            if(l_digit > 9 || l_value > (std::numeric_limits<uint64_t>::max() - l_digit) / 10)
+            {
+                return false;
+            }
+            l_value = 10 * l_value + l_digit;
+        }
+        p_value = l_value;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool parse_octal( const char * p_begin
+                    , const char * p_end
+                    , uint64_t & p_value
+                    )
+    {
+        uint64_t l_value = 0;
+        for(; p_begin < p_end; ++p_begin)
+        {
+            unsigned int l_digit = static_cast<unsigned char>(*p_begin) - '0';
+            if(l_digit > 7 || l_value >> 61)
+            {
+                return false;
+            }
+            l_value = (l_value << 3) | l_digit;
+        }
+        p_value = l_value;
+        return true;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    //-------------------------------------------------------------------------
+    bool parse_8_hexadecimal_digits( const char * p_digits
+                                   , uint32_t & p_value
+                                   )
+    {
+        const uint64_t l_ones = 0x0101010101010101ULL;
+        const uint64_t l_high_bits = 0x8080808080808080ULL;
+        uint64_t l_chars;
+        memcpy(&l_chars, p_digits, sizeof(l_chars));
+        if(l_chars & l_high_bits)
+        {
+            return false;
+        }
+        // For bytes lower than 0x80 high bit of x + 0x80 - low is set if
+        // x >= low and high bit of x + 0x7F - high is set if x > high
+        const auto l_in_range = [&](unsigned char p_low, unsigned char p_high) -> uint64_t
+        {
+            return (l_chars + l_ones * (0x80 - p_low)) & ~(l_chars + l_ones * (0x7F - p_high)) & l_high_bits;
+        };
+        if((l_in_range('0', '9') | l_in_range('A', 'F') | l_in_range('a', 'f')) != l_high_bits)
+        {
+            return false;
+        }
+        // Letters have bit 6 set and their low nibble is value - 9
+        uint64_t l_nibbles = (l_chars & (l_ones * 0x0F)) + 9 * ((l_chars & (l_ones * 0x40)) >> 6);
+        // First character is in lowest byte: merge neighbour bytes then
+        // neighbour 16 bits and 32 bits words, most significant first
+        uint64_t l_bytes = ((l_nibbles << 4) | (l_nibbles >> 8)) & 0x00FF00FF00FF00FFULL;
+        uint64_t l_words = ((l_bytes << 8) | (l_bytes >> 16)) & 0x0000FFFF0000FFFFULL;
+        p_value = static_cast<uint32_t>((l_words << 16) | (l_words >> 32));
+        return true;
+    }
+#endif // __BYTE_ORDER__
+
+}
+#endif //VALGRIND_LOG_TOOL_NUMBER_PARSER_H
+// EOF
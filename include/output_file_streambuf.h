@@ -0,0 +1,263 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_OUTPUT_FILE_STREAMBUF_H
+#define VALGRIND_LOG_TOOL_OUTPUT_FILE_STREAMBUF_H
+
+#include "quicky_exception.h"
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream buffer writing a file through a large buffer. Data reaches the
+     * file only when buffer is full or when stream is flushed, so that a
+     * report made of many short lines costs a few system calls. Data larger
+     * than buffer is written along with buffer content in a single call
+     */
+    class output_file_streambuf: public std::streambuf
+    {
+      public:
+
+        /**
+         * Create or truncate file
+         * @param p_name name of file
+         * @param p_buffer_size size of buffer in bytes
+         */
+        inline explicit
+        output_file_streambuf( const std::string & p_name
+                             , size_t p_buffer_size = 1 << 20
+                             );
+
+        output_file_streambuf(const output_file_streambuf &) = delete;
+
+        output_file_streambuf & operator=(const output_file_streambuf &) = delete;
+
+        /**
+         * Write remaining data and close file if not done. Errors are lost,
+         * file should be closed and checked before
+         */
+        inline
+        ~output_file_streambuf() override;
+
+        /**
+         * Write remaining data and close file. Nothing can be written after.
+         * Some file systems, like NFS, only report a deferred write error
+         * when file is closed
+         * @return true if whole file has been written
+         */
+        inline
+        bool close();
+
+        /**
+         * @return description of first write or close error, empty if none
+         */
+        inline
+        const std::string & get_error() const;
+
+      protected:
+
+        inline
+        int_type overflow(int_type p_char) override;
+
+        inline
+        std::streamsize xsputn( const char * p_source
+                              , std::streamsize p_size
+                              ) override;
+
+        inline
+        int sync() override;
+
+      private:
+
+        /**
+         * Write buffer content followed by data
+         * @param p_data data to write after buffer content, may be null
+         * @param p_size size of data
+         * @return true if everything has been written
+         */
+        inline
+        bool write_all( const char * p_data
+                      , size_t p_size
+                      );
+
+        int m_file_descriptor;
+        std::string m_name;
+        std::vector<char> m_buffer;
+        std::string m_error;
+    };
+
+    //-------------------------------------------------------------------------
+    output_file_streambuf::output_file_streambuf( const std::string & p_name
+                                                , size_t p_buffer_size
+                                                )
+    : m_file_descriptor(open(p_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+    , m_name(p_name)
+    , m_buffer(p_buffer_size)
+    {
+        if(m_file_descriptor < 0)
+        {
+            throw quicky_exception::quicky_runtime_exception("Unable to create file \"" + p_name + "\"", __LINE__, __FILE__);
+        }
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    }
+
+    //-------------------------------------------------------------------------
+    output_file_streambuf::~output_file_streambuf()
+    {
+        if(m_file_descriptor >= 0)
+        {
+            write_all(nullptr, 0);
+            ::close(m_file_descriptor);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    output_file_streambuf::close()
+    {
+        if(m_file_descriptor >= 0)
+        {
+            write_all(nullptr, 0);
+            if(::close(m_file_descriptor) && m_error.empty())
+            {
+                m_error = "Unable to close \"" + m_name + "\": " + strerror(errno);
+            }
+            m_file_descriptor = -1;
+            setp(nullptr, nullptr);
+        }
+        return m_error.empty();
+    }
+
+    //-------------------------------------------------------------------------
+    const std::string &
+    output_file_streambuf::get_error() const
+    {
+        return m_error;
+    }
+
+    //-------------------------------------------------------------------------
+    output_file_streambuf::int_type
+    output_file_streambuf::overflow(int_type p_char)
+    {
+        if(!write_all(nullptr, 0))
+        {
+            return traits_type::eof();
+        }
+        if(!traits_type::eq_int_type(p_char, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(p_char);
+            pbump(1);
+        }
+        return traits_type::not_eof(p_char);
+    }
+
+    //-------------------------------------------------------------------------
+    std::streamsize
+    output_file_streambuf::xsputn( const char * p_source
+                                 , std::streamsize p_size
+                                 )
+    {
+        if(p_size <= epptr() - pptr())
+        {
+            memcpy(pptr(), p_source, p_size);
+            pbump(static_cast<int>(p_size));
+            return p_size;
+        }
+        if(static_cast<size_t>(p_size) < m_buffer.size())
+        {
+            if(!write_all(nullptr, 0))
+            {
+                return 0;
+            }
+            memcpy(pptr(), p_source, p_size);
+            pbump(static_cast<int>(p_size));
+            return p_size;
+        }
+        return write_all(p_source, p_size) ? p_size : 0;
+    }
+
+    //-------------------------------------------------------------------------
+    int
+    output_file_streambuf::sync()
+    {
+        return write_all(nullptr, 0) ? 0 : -1;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    output_file_streambuf::write_all( const char * p_data
+                                    , size_t p_size
+                                    )
+    {
+        if(!m_error.empty() || m_file_descriptor < 0)
+        {
+            return false;
+        }
+        struct iovec l_vectors[2];
+        l_vectors[0].iov_base = pbase();
+        l_vectors[0].iov_len = pptr() - pbase();
+        l_vectors[1].iov_base = const_cast<char *>(p_data);
+        l_vectors[1].iov_len = p_size;
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        struct iovec * l_vector = l_vectors;
+        int l_vector_number = 2;
+        while(l_vector_number && !l_vector->iov_len)
+        {
+            ++l_vector;
+            --l_vector_number;
+        }
+        while(l_vector_number)
+        {
+            ssize_t l_written = writev(m_file_descriptor, l_vector, l_vector_number);
+            if(l_written < 0)
+            {
+                if(EINTR == errno)
+                {
+                    continue;
+                }
+                m_error = "Unable to write \"" + m_name + "\": " + strerror(errno);
+                return false;
+            }
+            // Skip what has been written, possibly only part of a vector
+            size_t l_remaining = l_written;
+            while(l_vector_number && l_remaining >= l_vector->iov_len)
+            {
+                l_remaining -= l_vector->iov_len;
+                ++l_vector;
+                --l_vector_number;
+            }
+            if(l_vector_number)
+            {
+                l_vector->iov_base = static_cast<char *>(l_vector->iov_base) + l_remaining;
+                l_vector->iov_len -= l_remaining;
+            }
+        }
+        return true;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_OUTPUT_FILE_STREAMBUF_H
+// EOF
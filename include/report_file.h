@@ -0,0 +1,100 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_REPORT_FILE_H
+#define VALGRIND_LOG_TOOL_REPORT_FILE_H
+
+#include "output_file_streambuf.h"
+#include "gzip_file_streambuf.h"
+#include "quicky_exception.h"
+#include <ostream>
+#include <memory>
+#include <string>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Stream writing a report file through a large buffer, data being
+     * compressed with gzip while written if asked
+     */
+    class report_file: public std::ostream
+    {
+      public:
+
+        /**
+         * Create or truncate file
+         * @param p_name name of file
+         * @param p_compressed true to compress file with gzip
+         * @param p_jobs number of threads compressing file
+         */
+        inline
+        report_file( const std::string & p_name
+                   , bool p_compressed = false
+                   , unsigned int p_jobs = 1
+                   );
+
+        /**
+         * Write remaining data, and gzip trailer if compressed, close file
+         * then check that whole file has been written. Report is only
+         * complete once remaining buffered data is written and file closed
+         */
+        inline
+        void close();
+
+      private:
+
+        std::unique_ptr<output_file_streambuf> m_buffer;
+        std::unique_ptr<gzip_file_streambuf> m_compressed_buffer;
+    };
+
+    //-------------------------------------------------------------------------
+    report_file::report_file( const std::string & p_name
+                            , bool p_compressed
+                            , unsigned int p_jobs
+                            )
+    : std::ostream(nullptr)
+    , m_buffer(p_compressed ? nullptr : new output_file_streambuf(p_name))
+    , m_compressed_buffer(p_compressed ? new gzip_file_streambuf(p_name, p_jobs) : nullptr)
+    {
+        rdbuf(p_compressed ? static_cast<std::streambuf *>(m_compressed_buffer.get()) : m_buffer.get());
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    report_file::close()
+    {
+        // A failed close makes flush fail
+        if(m_compressed_buffer)
+        {
+            m_compressed_buffer->close();
+        }
+        flush();
+        if(m_buffer && !m_buffer->close())
+        {
+            setstate(std::ios_base::badbit);
+        }
+        if(!*this)
+        {
+            const std::string & l_error = m_compressed_buffer ? m_compressed_buffer->get_error() : m_buffer->get_error();
+            throw quicky_exception::quicky_runtime_exception(l_error.empty() ? "Unable to write report" : l_error, __LINE__, __FILE__);
+        }
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_REPORT_FILE_H
+// EOF
@@ -0,0 +1,57 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_REPORT_GENERATOR_H
+#define VALGRIND_LOG_TOOL_REPORT_GENERATOR_H
+
+#include "valgrind_log_content.h"
+#include "valgrind_log_statistics.h"
+
+namespace valgrind_log_tool
+{
+    /**
+     * Output backend writing a report of content. Statistics are
+     * aggregated once and shared by all backends of a run
+     */
+    class report_generator
+    {
+      public:
+
+        inline virtual
+        ~report_generator();
+
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
+        virtual
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    report_generator::~report_generator()
+    {
+
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_REPORT_GENERATOR_H
+// EOF
@@ -0,0 +1,197 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_STRING_REF_H
+#define VALGRIND_LOG_TOOL_STRING_REF_H
+
+#include <string>
+#include <cstring>
+#include <ostream>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Non owning reference to a sequence of characters. Owner of characters
+     * must outlive the reference
+     */
+    class string_ref
+    {
+      public:
+
+        inline
+        string_ref();
+
+        inline
+        string_ref( const char * p_data
+                  , size_t p_size
+                  );
+
+        inline
+        string_ref(const std::string & p_string);
+
+        inline
+        const char * data() const;
+
+        inline
+        size_t size() const;
+
+        inline
+        bool empty() const;
+
+        inline
+        const char * begin() const;
+
+        inline
+        const char * end() const;
+
+        /**
+         * Build a copy of referenced characters
+         */
+        inline
+        std::string str() const;
+
+        inline
+        bool operator==(const string_ref & p_other) const;
+
+        inline
+        bool operator!=(const string_ref & p_other) const;
+
+        inline
+        bool operator<(const string_ref & p_other) const;
+
+      private:
+        const char * m_data;
+        size_t m_size;
+    };
+
+    inline
+    std::ostream & operator<<( std::ostream & p_stream
+                             , const string_ref & p_string
+                             );
+
+    inline
+    std::string operator+( std::string p_left
+                         , const string_ref & p_right
+                         );
+
+    //-------------------------------------------------------------------------
+    string_ref::string_ref()
+    : m_data("")
+    , m_size(0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref::string_ref( const char * p_data
+                          , size_t p_size
+                          )
+    : m_data(p_data)
+    , m_size(p_size)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref::string_ref(const std::string & p_string)
+    : m_data(p_string.data())
+    , m_size(p_string.size())
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    string_ref::data() const
+    {
+        return m_data;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    string_ref::size() const
+    {
+        return m_size;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    string_ref::empty() const
+    {
+        return !m_size;
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    string_ref::begin() const
+    {
+        return m_data;
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    string_ref::end() const
+    {
+        return m_data + m_size;
+    }
+
+    //-------------------------------------------------------------------------
+    std::string
+    string_ref::str() const
+    {
+        return std::string(m_data, m_size);
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    string_ref::operator==(const string_ref & p_other) const
+    {
+        return m_size == p_other.m_size && !memcmp(m_data, p_other.m_data, m_size);
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    string_ref::operator!=(const string_ref & p_other) const
+    {
+        return !(*this == p_other);
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    string_ref::operator<(const string_ref & p_other) const
+    {
+        int l_result = memcmp(m_data, p_other.m_data, m_size < p_other.m_size ? m_size : p_other.m_size);
+        return l_result < 0 || (!l_result && m_size < p_other.m_size);
+    }
+
+    //-------------------------------------------------------------------------
+    std::ostream & operator<<( std::ostream & p_stream
+                             , const string_ref & p_string
+                             )
+    {
+        return p_stream.write(p_string.data(), p_string.size());
+    }
+
+    //-------------------------------------------------------------------------
+    std::string operator+( std::string p_left
+                         , const string_ref & p_right
+                         )
+    {
+        return p_left.append(p_right.data(), p_right.size());
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_STRING_REF_H
+// EOF
@@ -0,0 +1,128 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_STRING_STORAGE_H
+#define VALGRIND_LOG_TOOL_STRING_STORAGE_H
+
+#include "string_ref.h"
+#include <vector>
+#include <memory>
+#include <cstring>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Own copies of strings in large blocks so that storing a string does
+     * not need its own heap allocation. Stored strings stay at the same
+     * address until storage is destroyed
+     */
+    class string_storage
+    {
+      public:
+
+        inline
+        string_storage();
+
+        string_storage(const string_storage &) = delete;
+
+        string_storage & operator=(const string_storage &) = delete;
+
+        /**
+         * Copy string in storage
+         * @param p_string string to copy
+         * @return reference to the copy
+         */
+        inline
+        string_ref store(const string_ref & p_string);
+
+        /**
+         * Take ownership of strings stored in another storage, references to
+         * them stay valid
+         * @param p_other storage to empty
+         */
+        inline
+        void take(string_storage & p_other);
+
+      private:
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+
+        /**
+         * Free part of last block
+         */
+        char * m_current;
+        size_t m_available;
+
+        static const size_t m_block_size = 1 << 16;
+    };
+
+    //-------------------------------------------------------------------------
+    string_storage::string_storage()
+    : m_current(nullptr)
+    , m_available(0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref
+    string_storage::store(const string_ref & p_string)
+    {
+        if(p_string.empty())
+        {
+            return string_ref();
+        }
+        size_t l_size = p_string.size();
+        char * l_destination;
+        if(l_size > m_available)
+        {
+            if(l_size > m_block_size / 4)
+            {
+                // Big strings get their own block to not waste current one
+                m_blocks.emplace_back(new char[l_size]);
+                l_destination = m_blocks.back().get();
+                memcpy(l_destination, p_string.data(), l_size);
+                return string_ref(l_destination, l_size);
+            }
+            m_blocks.emplace_back(new char[m_block_size]);
+            m_current = m_blocks.back().get();
+            m_available = m_block_size;
+        }
+        l_destination = m_current;
+        memcpy(l_destination, p_string.data(), l_size);
+        m_current += l_size;
+        m_available -= l_size;
+        return string_ref(l_destination, l_size);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    string_storage::take(string_storage & p_other)
+    {
+        // Free part of current block is kept so blocks order does not matter
+        for(auto & l_iter: p_other.m_blocks)
+        {
+            m_blocks.push_back(std::move(l_iter));
+        }
+        p_other.m_blocks.clear();
+        p_other.m_current = nullptr;
+        p_other.m_available = 0;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_STRING_STORAGE_H
+// EOF
@@ -19,15 +19,20 @@
 #ifndef VALGRIND_LOG_TOOL_VALGRIND_ERROR_H
 #define VALGRIND_LOG_TOOL_VALGRIND_ERROR_H
 
-#include "valgrind_frame.h"
+#include "valgrind_frame_table.h"
 #include "valgrind_xwhat.h"
+#include "valgrind_log_source.h"
 #include <cinttypes>
-#include <vector>
 #include <cassert>
 #include <functional>
 
 namespace valgrind_log_tool
 {
+    /**
+     * Error as read from log or as rebuilt from content error table. Kind
+     * is designated by its id in content symbol table, stack by indexes in
+     * content frame table
+     */
     class valgrind_error
     {
       public:
@@ -36,7 +41,7 @@ namespace valgrind_log_tool
         valgrind_error();
 
         inline
-        ~valgrind_error();
+        void set_source(const valgrind_log_source & p_source);
 
         inline
         void set_unique(uint64_t p_unique);
@@ -45,19 +50,32 @@ namespace valgrind_log_tool
         void set_tid(uint64_t p_tid);
 
         inline
-        void set_kind(std::string && p_kind);
+        void set_kind(uint32_t p_kind);
 
         inline
         void set_xwhat(const valgrind_xwhat & p_xwhat);
 
         inline
-        void set_what(std::string && p_what);
+        void set_what(const string_ref & p_what);
 
         inline
-        void set_aux_what(std::string && p_aux_what);
+        void set_aux_what(const string_ref & p_aux_what);
 
+        /**
+         * @param p_stack indexes of frames in content frame table, array
+         * is owned by content
+         * @param p_size number of frames
+         */
         inline
-        void add_frame(const valgrind_frame & p_frame);
+        void set_stack( const uint32_t * p_stack
+                      , uint32_t p_size
+                      );
+
+        /**
+         * @return log file error comes from
+         */
+        inline
+        const valgrind_log_source & get_source() const;
 
         inline
         const uint64_t & get_unique() const;
@@ -66,7 +84,7 @@ namespace valgrind_log_tool
         const uint64_t & get_tid() const;
 
         inline
-        const std::string & get_kind() const;
+        uint32_t get_kind() const;
 
         inline
         bool has_xwhat() const;
@@ -75,34 +93,59 @@ namespace valgrind_log_tool
         const valgrind_xwhat & get_xwhat() const;
 
         inline
-        const std::string & get_what() const;
+        const string_ref & get_what() const;
+
+        inline
+        const string_ref & get_aux_what() const;
 
+        /**
+         * @return indexes of stack frames in content frame table
+         */
         inline
-        const std::string & get_aux_what() const;
+        const uint32_t * get_stack() const;
 
         inline
-        void process_stack(const std::function<void(const valgrind_frame&)> & p_func) const;
+        uint32_t get_stack_size() const;
+
+        inline
+        void process_stack( const valgrind_frame_table & p_frames
+                          , const std::function<void(const valgrind_frame&)> & p_func
+                          ) const;
 
       private:
 
+        const valgrind_log_source * m_source;
         uint64_t m_unique;
         uint64_t m_tid;
-        std::string m_kind;
-        const valgrind_xwhat * m_xwhat;
-        std::string m_what;
-        std::string m_aux_what;
-        std::vector<const valgrind_frame *> m_stack;
+        uint32_t m_kind;
+        bool m_has_xwhat;
+        valgrind_xwhat m_xwhat;
+        string_ref m_what;
+        string_ref m_aux_what;
+        const uint32_t * m_stack;
+        uint32_t m_stack_size;
     };
 
     //-------------------------------------------------------------------------
     valgrind_error::valgrind_error()
-    : m_unique(0)
+    : m_source(nullptr)
+    , m_unique(0)
     , m_tid(0)
-    , m_xwhat(nullptr)
+    , m_kind(0)
+    , m_has_xwhat(false)
+    , m_stack(nullptr)
+    , m_stack_size(0)
     {
 
     }
 
+    //-------------------------------------------------------------------------
+    void
+    valgrind_error::set_source(const valgrind_log_source & p_source)
+    {
+        m_source = &p_source;
+    }
+
     //-------------------------------------------------------------------------
     void
     valgrind_error::set_unique(uint64_t p_unique)
@@ -119,56 +162,58 @@ namespace valgrind_log_tool
 
     //-------------------------------------------------------------------------
     void
-    valgrind_error::set_kind(std::string && p_kind)
+    valgrind_error::set_kind(uint32_t p_kind)
     {
         m_kind = p_kind;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_error::set_what(std::string && p_what)
+    valgrind_error::set_what(const string_ref & p_what)
     {
         m_what = p_what;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_error::set_aux_what(std::string && p_aux_what)
+    valgrind_error::set_aux_what(const string_ref & p_aux_what)
     {
         m_aux_what = p_aux_what;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_error::add_frame(const valgrind_frame & p_frame)
+    valgrind_error::set_stack( const uint32_t * p_stack
+                             , uint32_t p_size
+                             )
     {
-        m_stack.push_back(&p_frame);
-    }
-
-    //-------------------------------------------------------------------------
-    valgrind_error::~valgrind_error()
-    {
-        for(auto l_iter: m_stack)
-        {
-            delete l_iter;
-        }
-        delete m_xwhat;
+        m_stack = p_stack;
+        m_stack_size = p_size;
     }
 
     //-------------------------------------------------------------------------
     void
     valgrind_error::set_xwhat(const valgrind_xwhat & p_xwhat)
     {
-        m_xwhat = & p_xwhat;
+        m_xwhat = p_xwhat;
+        m_has_xwhat = true;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    uint32_t
     valgrind_error::get_kind() const
     {
         return m_kind;
     }
 
+    //-------------------------------------------------------------------------
+    const valgrind_log_source &
+    valgrind_error::get_source() const
+    {
+        assert(m_source);
+        return *m_source;
+    }
+
     //-------------------------------------------------------------------------
     const uint64_t &
     valgrind_error::get_unique() const
@@ -187,38 +232,54 @@ namespace valgrind_log_tool
     bool
     valgrind_error::has_xwhat() const
     {
-        return m_xwhat;
+        return m_has_xwhat;
     }
 
     //-------------------------------------------------------------------------
     const valgrind_xwhat &
     valgrind_error::get_xwhat() const
     {
-        assert(m_xwhat);
-        return *m_xwhat;
+        assert(m_has_xwhat);
+        return m_xwhat;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    const string_ref &
     valgrind_error::get_what() const
     {
         return m_what;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    const string_ref &
     valgrind_error::get_aux_what() const
     {
         return m_aux_what;
     }
 
+    //-------------------------------------------------------------------------
+    const uint32_t *
+    valgrind_error::get_stack() const
+    {
+        return m_stack;
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_error::get_stack_size() const
+    {
+        return m_stack_size;
+    }
+
     //-------------------------------------------------------------------------
     void
-    valgrind_error::process_stack(const std::function<void(const valgrind_frame &)> & p_func) const
+    valgrind_error::process_stack( const valgrind_frame_table & p_frames
+                                 , const std::function<void(const valgrind_frame &)> & p_func
+                                 ) const
     {
-        for(auto l_iter:m_stack)
+        for(uint32_t l_index = 0; l_index < m_stack_size; ++l_index)
         {
-            p_func(*l_iter);
+            p_func(p_frames.get(m_stack[l_index]));
         }
     }
 
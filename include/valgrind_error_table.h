@@ -0,0 +1,359 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_ERROR_TABLE_H
+#define VALGRIND_LOG_TOOL_VALGRIND_ERROR_TABLE_H
+
+#include "valgrind_error.h"
+#include <vector>
+#include <cinttypes>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Errors stored column by column: each field of error i is the i-th
+     * element of its own array and stacks are concatenated in a single array
+     * of frame indexes. Passes over one field then read contiguous memory
+     */
+    class valgrind_error_table
+    {
+      public:
+
+        inline
+        valgrind_error_table();
+
+        /**
+         * Append an error
+         * @param p_error error fields, its stack is ignored
+         * @param p_stack indexes of stack frames in content frame table
+         */
+        inline
+        void add( const valgrind_error & p_error
+                , const std::vector<uint32_t> & p_stack
+                );
+
+        inline
+        size_t get_size() const;
+
+        /**
+         * Rebuild an error from columns
+         * @param p_index index of error
+         * @return error whose stack refers to table, it stays valid until
+         * next error is added
+         */
+        inline
+        valgrind_error get(size_t p_index) const;
+
+        inline
+        const std::vector<const valgrind_log_source *> & get_sources() const;
+
+        inline
+        const std::vector<uint64_t> & get_uniques() const;
+
+        /**
+         * @return kind symbol id of each error
+         */
+        inline
+        const std::vector<uint32_t> & get_kinds() const;
+
+        inline
+        const std::vector<uint64_t> & get_tids() const;
+
+        inline
+        const std::vector<string_ref> & get_whats() const;
+
+        inline
+        const std::vector<string_ref> & get_aux_whats() const;
+
+        /**
+         * @return non zero for each error having an xwhat
+         */
+        inline
+        const std::vector<char> & get_has_xwhats() const;
+
+        /**
+         * @return xwhat text of each error, empty if it has no xwhat
+         */
+        inline
+        const std::vector<string_ref> & get_xwhat_texts() const;
+
+        inline
+        const std::vector<uint64_t> & get_leaked_bytes() const;
+
+        inline
+        const std::vector<uint64_t> & get_leaked_blocks() const;
+
+        /**
+         * @return position of each error stack in stack frames followed by
+         * number of stack frames, so that stack of error i goes from
+         * element i to element i + 1 excluded
+         */
+        inline
+        const std::vector<size_t> & get_stack_offsets() const;
+
+        /**
+         * @return frame indexes of all stacks
+         */
+        inline
+        const std::vector<uint32_t> & get_stack_frames() const;
+
+        /**
+         * Move errors of another table after the ones of this table
+         * @param p_other table to empty
+         * @param p_symbol_ids new id of each symbol of other table, empty if
+         * ids did not change
+         * @param p_frame_indexes new index of each frame of other table,
+         * empty if indexes did not change
+         */
+        inline
+        void take( valgrind_error_table & p_other
+                 , const std::vector<uint32_t> & p_symbol_ids
+                 , const std::vector<uint32_t> & p_frame_indexes
+                 );
+
+      private:
+
+        /**
+         * Move one column of another table after the one of this table
+         */
+        template <typename T>
+        static void append( std::vector<T> & p_column
+                          , std::vector<T> & p_other_column
+                          );
+
+        std::vector<const valgrind_log_source *> m_sources;
+        std::vector<uint64_t> m_uniques;
+        std::vector<uint64_t> m_tids;
+        std::vector<uint32_t> m_kinds;
+        std::vector<string_ref> m_whats;
+        std::vector<string_ref> m_aux_whats;
+        std::vector<char> m_has_xwhats;
+        std::vector<string_ref> m_xwhat_texts;
+        std::vector<uint64_t> m_leaked_bytes;
+        std::vector<uint64_t> m_leaked_blocks;
+        std::vector<size_t> m_stack_offsets;
+        std::vector<uint32_t> m_stack_frames;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_error_table::valgrind_error_table()
+    : m_stack_offsets(1, 0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_error_table::add( const valgrind_error & p_error
+                             , const std::vector<uint32_t> & p_stack
+                             )
+    {
+        m_sources.push_back(&p_error.get_source());
+        m_uniques.push_back(p_error.get_unique());
+        m_tids.push_back(p_error.get_tid());
+        m_kinds.push_back(p_error.get_kind());
+        m_whats.push_back(p_error.get_what());
+        m_aux_whats.push_back(p_error.get_aux_what());
+        m_has_xwhats.push_back(p_error.has_xwhat());
+        valgrind_xwhat l_xwhat = p_error.has_xwhat() ? p_error.get_xwhat() : valgrind_xwhat();
+        m_xwhat_texts.push_back(l_xwhat.get_text());
+        m_leaked_bytes.push_back(l_xwhat.get_leaked_bytes());
+        m_leaked_blocks.push_back(l_xwhat.get_leaked_blocks());
+        m_stack_frames.insert(m_stack_frames.end(), p_stack.begin(), p_stack.end());
+        m_stack_offsets.push_back(m_stack_frames.size());
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    valgrind_error_table::get_size() const
+    {
+        return m_uniques.size();
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_error
+    valgrind_error_table::get(size_t p_index) const
+    {
+        assert(p_index < get_size());
+        valgrind_error l_error;
+        l_error.set_source(*m_sources[p_index]);
+        l_error.set_unique(m_uniques[p_index]);
+        l_error.set_tid(m_tids[p_index]);
+        l_error.set_kind(m_kinds[p_index]);
+        l_error.set_what(m_whats[p_index]);
+        l_error.set_aux_what(m_aux_whats[p_index]);
+        if(m_has_xwhats[p_index])
+        {
+            valgrind_xwhat l_xwhat;
+            l_xwhat.set_text(m_xwhat_texts[p_index]);
+            l_xwhat.set_leaked_bytes(m_leaked_bytes[p_index]);
+            l_xwhat.set_leaked_blocks(m_leaked_blocks[p_index]);
+            l_error.set_xwhat(l_xwhat);
+        }
+        size_t l_begin = m_stack_offsets[p_index];
+        l_error.set_stack(m_stack_frames.data() + l_begin, static_cast<uint32_t>(m_stack_offsets[p_index + 1] - l_begin));
+        return l_error;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<const valgrind_log_source *> &
+    valgrind_error_table::get_sources() const
+    {
+        return m_sources;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint64_t> &
+    valgrind_error_table::get_uniques() const
+    {
+        return m_uniques;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint32_t> &
+    valgrind_error_table::get_kinds() const
+    {
+        return m_kinds;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint64_t> &
+    valgrind_error_table::get_tids() const
+    {
+        return m_tids;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<string_ref> &
+    valgrind_error_table::get_whats() const
+    {
+        return m_whats;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<string_ref> &
+    valgrind_error_table::get_aux_whats() const
+    {
+        return m_aux_whats;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<char> &
+    valgrind_error_table::get_has_xwhats() const
+    {
+        return m_has_xwhats;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<string_ref> &
+    valgrind_error_table::get_xwhat_texts() const
+    {
+        return m_xwhat_texts;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint64_t> &
+    valgrind_error_table::get_leaked_bytes() const
+    {
+        return m_leaked_bytes;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint64_t> &
+    valgrind_error_table::get_leaked_blocks() const
+    {
+        return m_leaked_blocks;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<size_t> &
+    valgrind_error_table::get_stack_offsets() const
+    {
+        return m_stack_offsets;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint32_t> &
+    valgrind_error_table::get_stack_frames() const
+    {
+        return m_stack_frames;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    void
+    valgrind_error_table::append( std::vector<T> & p_column
+                                , std::vector<T> & p_other_column
+                                )
+    {
+        if(p_column.empty())
+        {
+            p_column.swap(p_other_column);
+        }
+        else
+        {
+            p_column.insert(p_column.end(), p_other_column.begin(), p_other_column.end());
+        }
+        p_other_column.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_error_table::take( valgrind_error_table & p_other
+                              , const std::vector<uint32_t> & p_symbol_ids
+                              , const std::vector<uint32_t> & p_frame_indexes
+                              )
+    {
+        if(!p_symbol_ids.empty())
+        {
+            for(auto & l_iter: p_other.m_kinds)
+            {
+                assert(l_iter < p_symbol_ids.size());
+                l_iter = p_symbol_ids[l_iter];
+            }
+        }
+        if(!p_frame_indexes.empty())
+        {
+            for(auto & l_iter: p_other.m_stack_frames)
+            {
+                assert(l_iter < p_frame_indexes.size());
+                l_iter = p_frame_indexes[l_iter];
+            }
+        }
+        size_t l_stack_frame_number = m_stack_frames.size();
+        for(size_t l_index = 1; l_index < p_other.m_stack_offsets.size(); ++l_index)
+        {
+            m_stack_offsets.push_back(l_stack_frame_number + p_other.m_stack_offsets[l_index]);
+        }
+        p_other.m_stack_offsets.resize(1);
+        append(m_sources, p_other.m_sources);
+        append(m_uniques, p_other.m_uniques);
+        append(m_tids, p_other.m_tids);
+        append(m_kinds, p_other.m_kinds);
+        append(m_whats, p_other.m_whats);
+        append(m_aux_whats, p_other.m_aux_whats);
+        append(m_has_xwhats, p_other.m_has_xwhats);
+        append(m_xwhat_texts, p_other.m_xwhat_texts);
+        append(m_leaked_bytes, p_other.m_leaked_bytes);
+        append(m_leaked_blocks, p_other.m_leaked_blocks);
+        append(m_stack_frames, p_other.m_stack_frames);
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_ERROR_TABLE_H
+// EOF
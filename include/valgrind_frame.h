@@ -20,10 +20,15 @@
 #define VALGRIND_LOG_TOOL_VALGRIND_FRAME_H
 
 #include <cinttypes>
-#include <string>
+#include <vector>
+#include <cassert>
 
 namespace valgrind_log_tool
 {
+    /**
+     * Object, function, directory and file of a frame are designated by
+     * their id in content symbol table, 0 meaning unknown
+     */
     class valgrind_frame
     {
       public:
@@ -34,16 +39,16 @@ namespace valgrind_log_tool
         void set_ip(uint64_t p_ip);
 
         inline
-        void set_obj(std::string && p_obj);
+        void set_obj(uint32_t p_obj);
 
         inline
-        void set_fn(std::string && p_fn);
+        void set_fn(uint32_t p_fn);
 
         inline
-        void set_dir(std::string && p_dir);
+        void set_dir(uint32_t p_dir);
 
         inline
-        void set_file(std::string && p_file);
+        void set_file(uint32_t p_file);
 
         inline
         void set_line(uint32_t p_line);
@@ -52,32 +57,46 @@ namespace valgrind_log_tool
         const uint64_t & get_ip() const;
 
         inline
-        const std::string & get_obj() const;
+        uint32_t get_obj() const;
 
         inline
-        const std::string & get_fn() const;
+        uint32_t get_fn() const;
 
         inline
-        const std::string & get_dir() const;
+        uint32_t get_dir() const;
 
         inline
-        const std::string & get_file() const;
+        uint32_t get_file() const;
 
         inline
         const uint32_t & get_line() const;
 
+        inline
+        bool operator==(const valgrind_frame & p_other) const;
+
+        /**
+         * Update symbol ids once symbol table has been merged in another
+         * @param p_ids new id of each symbol
+         */
+        inline
+        void renumber_symbols(const std::vector<uint32_t> & p_ids);
+
       private:
         uint64_t m_ip;
-        std::string m_obj;
-        std::string m_fn;
-        std::string m_dir;
-        std::string m_file;
+        uint32_t m_obj;
+        uint32_t m_fn;
+        uint32_t m_dir;
+        uint32_t m_file;
         uint32_t m_line;
     };
 
     //-------------------------------------------------------------------------
     valgrind_frame::valgrind_frame()
     : m_ip(0)
+    , m_obj(0)
+    , m_fn(0)
+    , m_dir(0)
+    , m_file(0)
     , m_line(0)
     {
 
@@ -92,28 +111,28 @@ namespace valgrind_log_tool
 
     //-------------------------------------------------------------------------
     void
-    valgrind_frame::set_obj(std::string && p_obj)
+    valgrind_frame::set_obj(uint32_t p_obj)
     {
         m_obj = p_obj;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_frame::set_fn(std::string && p_fn)
+    valgrind_frame::set_fn(uint32_t p_fn)
     {
         m_fn = p_fn;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_frame::set_dir(std::string && p_dir)
+    valgrind_frame::set_dir(uint32_t p_dir)
     {
         m_dir = p_dir;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_frame::set_file(std::string && p_file)
+    valgrind_frame::set_file(uint32_t p_file)
     {
         m_file = p_file;
     }
@@ -133,28 +152,28 @@ namespace valgrind_log_tool
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    uint32_t
     valgrind_frame::get_obj() const
     {
         return m_obj;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    uint32_t
     valgrind_frame::get_fn() const
     {
         return m_fn;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    uint32_t
     valgrind_frame::get_dir() const
     {
         return m_dir;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    uint32_t
     valgrind_frame::get_file() const
     {
         return m_file;
@@ -166,5 +185,28 @@ namespace valgrind_log_tool
     {
         return m_line;
     }
+
+    //-------------------------------------------------------------------------
+    bool
+    valgrind_frame::operator==(const valgrind_frame & p_other) const
+    {
+        return m_ip == p_other.m_ip
+            && m_line == p_other.m_line
+            && m_fn == p_other.m_fn
+            && m_file == p_other.m_file
+            && m_dir == p_other.m_dir
+            && m_obj == p_other.m_obj;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_frame::renumber_symbols(const std::vector<uint32_t> & p_ids)
+    {
+        assert(m_obj < p_ids.size() && m_fn < p_ids.size() && m_dir < p_ids.size() && m_file < p_ids.size());
+        m_obj = p_ids[m_obj];
+        m_fn = p_ids[m_fn];
+        m_dir = p_ids[m_dir];
+        m_file = p_ids[m_file];
+    }
 }
 #endif //VALGRIND_LOG_TOOL_VALGRIND_FRAME_H
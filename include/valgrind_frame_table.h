@@ -0,0 +1,141 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_FRAME_TABLE_H
+#define VALGRIND_LOG_TOOL_VALGRIND_FRAME_TABLE_H
+
+#include "valgrind_frame.h"
+#include <vector>
+#include <unordered_map>
+#include <cinttypes>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Frames shared by all errors of a content. A frame mentioned by several
+     * errors is stored once and errors refer to it by its index
+     */
+    class valgrind_frame_table
+    {
+      public:
+
+        /**
+         * Find frame equal to the one given, store it if not yet known
+         * @param p_frame frame read from log
+         * @return index of frame in table
+         */
+        inline
+        uint32_t add(const valgrind_frame & p_frame);
+
+        inline
+        const valgrind_frame & get(uint32_t p_index) const;
+
+        inline
+        uint32_t get_size() const;
+
+        /**
+         * Move frames of another table in this one
+         * @param p_other table to empty
+         * @param p_symbol_ids new id of each symbol referenced by frames of
+         * other table, empty if ids did not change
+         * @return new index of each frame of other table, empty if indexes
+         * did not change
+         */
+        inline
+        std::vector<uint32_t> take( valgrind_frame_table & p_other
+                                  , const std::vector<uint32_t> & p_symbol_ids
+                                  );
+
+      private:
+
+        std::vector<valgrind_frame> m_frames;
+
+        /**
+         * Frame indexes by instruction pointer. Logs of different processes
+         * can use the same instruction pointer for different frames
+         */
+        std::unordered_multimap<uint64_t, uint32_t> m_indexes;
+    };
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_frame_table::add(const valgrind_frame & p_frame)
+    {
+        auto l_range = m_indexes.equal_range(p_frame.get_ip());
+        for(auto l_iter = l_range.first; l_iter != l_range.second; ++l_iter)
+        {
+            if(m_frames[l_iter->second] == p_frame)
+            {
+                return l_iter->second;
+            }
+        }
+        uint32_t l_index = static_cast<uint32_t>(m_frames.size());
+        m_frames.push_back(p_frame);
+        m_indexes.insert(std::make_pair(p_frame.get_ip(), l_index));
+        return l_index;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_frame &
+    valgrind_frame_table::get(uint32_t p_index) const
+    {
+        assert(p_index < m_frames.size());
+        return m_frames[p_index];
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_frame_table::get_size() const
+    {
+        return static_cast<uint32_t>(m_frames.size());
+    }
+
+    //-------------------------------------------------------------------------
+    std::vector<uint32_t>
+    valgrind_frame_table::take( valgrind_frame_table & p_other
+                              , const std::vector<uint32_t> & p_symbol_ids
+                              )
+    {
+        if(!p_symbol_ids.empty())
+        {
+            for(auto & l_iter: p_other.m_frames)
+            {
+                l_iter.renumber_symbols(p_symbol_ids);
+            }
+        }
+        std::vector<uint32_t> l_indexes;
+        if(m_frames.empty())
+        {
+            m_frames.swap(p_other.m_frames);
+            m_indexes.swap(p_other.m_indexes);
+            return l_indexes;
+        }
+        l_indexes.reserve(p_other.m_frames.size());
+        for(const auto & l_iter: p_other.m_frames)
+        {
+            l_indexes.push_back(add(l_iter));
+        }
+        p_other.m_frames.clear();
+        p_other.m_indexes.clear();
+        return l_indexes;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_FRAME_TABLE_H
+// EOF
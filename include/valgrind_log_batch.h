@@ -0,0 +1,219 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_LOG_BATCH_H
+#define VALGRIND_LOG_TOOL_VALGRIND_LOG_BATCH_H
+
+#include "valgrind_log_parser.h"
+#include "quicky_exception.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Parse several log files, for example the ones produced by valgrind
+     * option --xml-file=report.%p.xml, on a pool of threads with one parser
+     * per file. Errors are stored in content in the order of files
+     */
+    class valgrind_log_batch
+    {
+      public:
+
+        /**
+         * Parse log files
+         * @param p_log_names names of log files
+         * @param p_content content to fill
+         * @param p_mode way log files are read
+         * @param p_jobs number of threads. When there is only one file they
+         * are used to split it if it is mapped
+         */
+        inline
+        valgrind_log_batch( const std::vector<std::string> & p_log_names
+                          , valgrind_log_content & p_content
+                          , valgrind_log_parser::t_input_mode p_mode
+                          , unsigned int p_jobs
+                          );
+
+        /**
+         * @return number of nodes that have been treated in all files
+         */
+        inline
+        uint64_t get_node_number() const;
+
+        /**
+         * Replace directories by the log files they contain, ie files whose
+         * name ends with ".xml", ".xml.gz" or ".xml.zst", sorted by name
+         * @param p_names names of files or directories
+         * @return names of files
+         */
+        inline static
+        std::vector<std::string> expand(const std::vector<std::string> & p_names);
+
+      private:
+
+        uint64_t m_node_number;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_log_batch::valgrind_log_batch( const std::vector<std::string> & p_log_names
+                                          , valgrind_log_content & p_content
+                                          , valgrind_log_parser::t_input_mode p_mode
+                                          , unsigned int p_jobs
+                                          )
+    : m_node_number(0)
+    {
+        if(1 == p_log_names.size())
+        {
+            valgrind_log_parser l_parser(p_log_names.front(), p_content, p_mode, p_jobs);
+            m_node_number = l_parser.get_node_number();
+            return;
+        }
+
+        // Sources are declared in files order so that they are numbered
+        // whatever the order in which files are parsed
+        size_t l_file_number = p_log_names.size();
+        std::vector<valgrind_log_source *> l_sources;
+        std::vector<std::unique_ptr<valgrind_log_content>> l_contents;
+        for(const auto & l_iter: p_log_names)
+        {
+            l_sources.push_back(&p_content.add_source(l_iter));
+            l_contents.emplace_back(new valgrind_log_content());
+        }
+        std::vector<uint64_t> l_node_numbers(l_file_number, 0);
+        std::vector<std::exception_ptr> l_exceptions(l_file_number);
+
+        // Each thread takes next file not yet parsed
+        std::atomic<size_t> l_next_file{0};
+        const auto l_work = [&]()
+        {
+            size_t l_index;
+            while((l_index = l_next_file++) < l_file_number)
+            {
+                try
+                {
+                    valgrind_log_parser l_parser(*l_sources[l_index], *l_contents[l_index], p_mode);
+                    l_node_numbers[l_index] = l_parser.get_node_number();
+                }
+                catch(...)
+                {
+                    l_exceptions[l_index] = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> l_threads;
+        for(size_t l_index = 1; l_index < std::min(static_cast<size_t>(p_jobs), l_file_number); ++l_index)
+        {
+            l_threads.emplace_back(l_work);
+        }
+        l_work();
+        for(auto & l_iter: l_threads)
+        {
+            l_iter.join();
+        }
+
+        // Report error of first invalid file like a sequential parsing would do
+        for(const auto & l_iter: l_exceptions)
+        {
+            if(l_iter)
+            {
+                std::rethrow_exception(l_iter);
+            }
+        }
+        for(size_t l_index = 0; l_index < l_file_number; ++l_index)
+        {
+            p_content.take(*l_contents[l_index]);
+            m_node_number += l_node_numbers[l_index];
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    uint64_t
+    valgrind_log_batch::get_node_number() const
+    {
+        return m_node_number;
+    }
+
+    //-------------------------------------------------------------------------
+    std::vector<std::string>
+    valgrind_log_batch::expand(const std::vector<std::string> & p_names)
+    {
+        std::vector<std::string> l_result;
+        for(const auto & l_name: p_names)
+        {
+            struct stat l_stat;
+            if(stat(l_name.c_str(), &l_stat) || !S_ISDIR(l_stat.st_mode))
+            {
+                l_result.push_back(l_name);
+                continue;
+            }
+            DIR * l_directory = opendir(l_name.c_str());
+            if(!l_directory)
+            {
+                throw quicky_exception::quicky_runtime_exception("Unable to read directory \"" + l_name + "\"", __LINE__, __FILE__);
+            }
+            std::vector<std::string> l_files;
+            const std::vector<std::string> l_extensions{".xml", ".xml.gz", ".xml.zst"};
+            const auto l_has_log_extension = [&](const std::string & p_file_name)
+            {
+                for(const auto & l_extension: l_extensions)
+                {
+                    if(p_file_name.size() > l_extension.size()
+                       && !p_file_name.compare(p_file_name.size() - l_extension.size(), l_extension.size(), l_extension)
+                      )
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            struct dirent * l_entry;
+            while(nullptr != (l_entry = readdir(l_directory)))
+            {
+                std::string l_file_name{l_entry->d_name};
+                std::string l_path = l_name + "/" + l_file_name;
+                if(l_has_log_extension(l_file_name)
+                   && !stat(l_path.c_str(), &l_stat)
+                   && S_ISREG(l_stat.st_mode)
+                  )
+                {
+                    l_files.push_back(l_path);
+                }
+            }
+            closedir(l_directory);
+            if(l_files.empty())
+            {
+                throw quicky_exception::quicky_logic_exception("No valgrind log in directory \"" + l_name + "\"", __LINE__, __FILE__);
+            }
+            std::sort(l_files.begin(), l_files.end());
+            l_result.insert(l_result.end(), l_files.begin(), l_files.end());
+        }
+        return l_result;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_BATCH_H
+// EOF
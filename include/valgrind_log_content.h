@@ -19,8 +19,14 @@
 #ifndef VALGRIND_LOG_TOOL_VALGRIND_LOG_CONTENT_H
 #define VALGRIND_LOG_TOOL_VALGRIND_LOG_CONTENT_H
 
-#include "valgrind_error.h"
+#include "valgrind_error_table.h"
+#include "valgrind_frame_table.h"
+#include "valgrind_symbol_table.h"
+#include "valgrind_log_source.h"
+#include "string_storage.h"
+#include "mapped_file.h"
 #include <vector>
+#include <memory>
 #include <map>
 #include <cinttypes>
 #include <functional>
@@ -32,68 +38,312 @@ namespace valgrind_log_tool
     {
       public:
 
+        /**
+         * Store an error
+         * @param p_error error whose strings live as long as content, its
+         * stack is ignored
+         * @param p_stack indexes of stack frames returned by add_frame
+         */
         inline
-        void add_error(const valgrind_error & p_error);
+        void add_error( const valgrind_error & p_error
+                      , const std::vector<uint32_t> & p_stack
+                      );
 
+        /**
+         * Intern a frame read from log
+         * @param p_frame frame whose symbols are stored in content
+         * @return index of frame to store in error stack
+         */
         inline
-        void add_error_count( uint64_t p_unique
+        uint32_t add_frame(const valgrind_frame & p_frame);
+
+        /**
+         * Intern a frame object, function, directory or file name
+         * @param p_string name read from log
+         * @param p_persistent true if name lives as long as content
+         * @return id of name to store in frame
+         */
+        inline
+        uint32_t add_symbol( const string_ref & p_string
+                           , bool p_persistent
+                           );
+
+        /**
+         * @param p_id symbol id stored in a frame
+         * @return name designated by id, empty for id 0
+         */
+        inline
+        const string_ref & get_symbol(uint32_t p_id) const;
+
+        /**
+         * @return number of symbols, ids are lower than it
+         */
+        inline
+        uint32_t get_symbol_number() const;
+
+        /**
+         * @return errors stored column by column for passes over a few
+         * fields of all errors
+         */
+        inline
+        const valgrind_error_table & get_errors() const;
+
+        /**
+         * @return frames referenced by error stacks
+         */
+        inline
+        const valgrind_frame_table & get_frames() const;
+
+        /**
+         * Call function for each frame of error stack
+         */
+        inline
+        void process_stack( const valgrind_error & p_error
+                          , const std::function<void(const valgrind_frame &)> & p_func
+                          ) const;
+
+        /**
+         * Store number of occurences of an error. Unique ids are only unique
+         * in their log file
+         * @param p_source log file error comes from
+         * @param p_unique error unique id
+         * @param p_count number of occurences
+         */
+        inline
+        void add_error_count( const valgrind_log_source & p_source
+                            , uint64_t p_unique
                             , uint32_t p_count
                             );
 
+        /**
+         * Declare a log file whose errors will be stored in content
+         * @param p_name name of log file
+         * @return source to set in errors, it lives as long as content
+         */
+        inline
+        valgrind_log_source & add_source(const std::string & p_name);
+
+        inline
+        size_t get_source_number() const;
+
+        inline
+        void process_sources(const std::function<void(const valgrind_log_source &)> & p_func) const;
+
+        inline
+        size_t get_error_number() const;
+
         inline
         void process_errors(const std::function<void(const valgrind_error&)> & p_func) const;
 
+        /**
+         * Call function for each error count ordered by source then unique id
+         */
         inline
-        void process_error_counts(const std::function<void(const std::pair<uint64_t, uint32_t> &)> & p_func) const;
+        void process_error_counts(const std::function<void(const valgrind_log_source &, uint64_t, uint32_t)> & p_func) const;
 
+        /**
+         * Copy string in content so that it lives as long as content
+         * @param p_string string to copy
+         * @return reference to copy owned by content
+         */
         inline
-        ~valgrind_log_content();
+        string_ref store_string(const string_ref & p_string);
+
+        /**
+         * Keep file mapping alive as long as content as errors can
+         * reference strings located in it
+         * @param p_mapping mapping to keep
+         */
+        inline
+        void add_mapping(std::unique_ptr<const mapped_file> && p_mapping);
+
+        /**
+         * Move errors, error counts, frames, symbols, strings and mappings of
+         * another content after the ones of this content. Stacks of moved
+         * errors are renumbered to refer to frames of this content. Like
+         * with add_error_count, error counts already known are kept. Sources
+         * stay owned by the content they have been added to
+         * @param p_other content to empty
+         */
+        inline
+        void take(valgrind_log_content & p_other);
 
       private:
-        std::vector<const valgrind_error *> m_errors;
-        std::map<uint64_t, uint32_t> m_error_counts;
+        valgrind_error_table m_errors;
+
+        valgrind_frame_table m_frames;
+
+        valgrind_symbol_table m_symbols;
+
+        /**
+         * Source and number of occurences indexed by source index and
+         * error unique id
+         */
+        std::map<std::pair<unsigned int, uint64_t>, std::pair<const valgrind_log_source *, uint32_t>> m_error_counts;
+
+        std::vector<std::unique_ptr<valgrind_log_source>> m_sources;
+
+        /**
+         * Strings that are not located in a mapped file
+         */
+        string_storage m_strings;
+
+        std::vector<std::unique_ptr<const mapped_file>> m_mappings;
     };
 
     //-------------------------------------------------------------------------
-    valgrind_log_content::~valgrind_log_content()
+    void
+    valgrind_log_content::add_error( const valgrind_error & p_error
+                                   , const std::vector<uint32_t> & p_stack
+                                   )
     {
-        for(auto l_iter:m_errors)
-        {
-            delete l_iter;
-        }
+        m_errors.add(p_error, p_stack);
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_content::add_frame(const valgrind_frame & p_frame)
+    {
+        return m_frames.add(p_frame);
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_content::add_symbol( const string_ref & p_string
+                                    , bool p_persistent
+                                    )
+    {
+        return m_symbols.add(p_string, p_persistent);
+    }
+
+    //-------------------------------------------------------------------------
+    const string_ref &
+    valgrind_log_content::get_symbol(uint32_t p_id) const
+    {
+        return m_symbols.get(p_id);
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_content::get_symbol_number() const
+    {
+        return m_symbols.get_size();
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_error_table &
+    valgrind_log_content::get_errors() const
+    {
+        return m_errors;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_frame_table &
+    valgrind_log_content::get_frames() const
+    {
+        return m_frames;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_content::add_error(const valgrind_error & p_error)
+    valgrind_log_content::process_stack( const valgrind_error & p_error
+                                       , const std::function<void(const valgrind_frame &)> & p_func
+                                       ) const
     {
-        m_errors.push_back(&p_error);
+        p_error.process_stack(m_frames, p_func);
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_content::add_error_count( uint64_t p_unique
+    valgrind_log_content::add_error_count( const valgrind_log_source & p_source
+                                         , uint64_t p_unique
                                          , uint32_t p_count
                                          )
     {
-        m_error_counts.insert(std::pair<uint64_t, uint32_t>(p_unique, p_count));
+        m_error_counts.insert(std::make_pair(std::make_pair(p_source.get_index(), p_unique), std::make_pair(&p_source, p_count)));
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_source &
+    valgrind_log_content::add_source(const std::string & p_name)
+    {
+        m_sources.emplace_back(new valgrind_log_source(m_sources.size(), p_name));
+        return *m_sources.back();
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    valgrind_log_content::get_source_number() const
+    {
+        return m_sources.size();
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_content::process_errors(const std::function<void(const valgrind_error &)> & p_func) const
+    valgrind_log_content::process_sources(const std::function<void(const valgrind_log_source &)> & p_func) const
     {
-        for(auto l_iter: m_errors)
+        for(const auto & l_iter: m_sources)
         {
             p_func(*l_iter);
         }
     }
 
+    //-------------------------------------------------------------------------
+    string_ref
+    valgrind_log_content::store_string(const string_ref & p_string)
+    {
+        return m_strings.store(p_string);
+    }
+
     //-------------------------------------------------------------------------
     void
-    valgrind_log_content::process_error_counts(const std::function<void(const std::pair<uint64_t, uint32_t> &)> & p_func) const
+    valgrind_log_content::add_mapping(std::unique_ptr<const mapped_file> && p_mapping)
     {
-        for_each(m_error_counts.begin(), m_error_counts.end(), p_func);
+        m_mappings.push_back(std::move(p_mapping));
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_content::take(valgrind_log_content & p_other)
+    {
+        std::vector<uint32_t> l_symbol_ids = m_symbols.take(p_other.m_symbols);
+        std::vector<uint32_t> l_frame_indexes = m_frames.take(p_other.m_frames, l_symbol_ids);
+        m_errors.take(p_other.m_errors, l_symbol_ids, l_frame_indexes);
+        m_error_counts.insert(p_other.m_error_counts.begin(), p_other.m_error_counts.end());
+        p_other.m_error_counts.clear();
+        m_strings.take(p_other.m_strings);
+        for(auto & l_iter: p_other.m_mappings)
+        {
+            m_mappings.push_back(std::move(l_iter));
+        }
+        p_other.m_mappings.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    valgrind_log_content::get_error_number() const
+    {
+        return m_errors.get_size();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_content::process_errors(const std::function<void(const valgrind_error &)> & p_func) const
+    {
+        for(size_t l_index = 0; l_index < m_errors.get_size(); ++l_index)
+        {
+            p_func(m_errors.get(l_index));
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_content::process_error_counts(const std::function<void(const valgrind_log_source &, uint64_t, uint32_t)> & p_func) const
+    {
+        for(const auto & l_iter: m_error_counts)
+        {
+            p_func(*l_iter.second.first, l_iter.first.second, l_iter.second.second);
+        }
     }
 }
 #endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_CONTENT_H
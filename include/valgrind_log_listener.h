@@ -0,0 +1,415 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_LOG_LISTENER_H
+#define VALGRIND_LOG_TOOL_VALGRIND_LOG_LISTENER_H
+
+#include "valgrind_log_parser.h"
+#include "fd_streambuf.h"
+#include "number_parser.h"
+#include "quicky_exception.h"
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Receive XML logs sent by valgrind option --xml-socket=host:port. Each
+     * connection is parsed by its own thread as data arrives, log is never
+     * written on disk. Errors received by a connection are handed over as
+     * they are stored and moved in content by the thread calling run, so
+     * content grows while valgrind processes are still running
+     */
+    class valgrind_log_listener
+    {
+      public:
+
+        /**
+         * Start listening
+         * @param p_address port or address:port, localhost is used if there
+         * is no address
+         * @param p_content content to fill
+         */
+        inline
+        valgrind_log_listener( const std::string & p_address
+                             , valgrind_log_content & p_content
+                             );
+
+        valgrind_log_listener(const valgrind_log_listener &) = delete;
+
+        valgrind_log_listener & operator=(const valgrind_log_listener &) = delete;
+
+        inline
+        ~valgrind_log_listener();
+
+        /**
+         * Accept and treat connections. An exception thrown by p_update or
+         * by a connection thread closes all connections then is rethrown
+         * once threads are stopped
+         * @param p_connection_number number of connections to accept before
+         * stopping, 0 for no limit
+         * @param p_interrupted function called regularly, if it returns true
+         * connections still open are closed and errors they already sent are
+         * kept
+         * @param p_update function called regularly, after errors received
+         * since previous call have been moved in content. It is called by
+         * the thread calling run and content is not modified during call,
+         * connections go on being parsed meanwhile
+         */
+        inline
+        void run( unsigned int p_connection_number
+                , const std::function<bool()> & p_interrupted
+                , const std::function<void()> & p_update
+                );
+
+        /**
+         * @return number of nodes that have been treated in all connections
+         */
+        inline
+        uint64_t get_node_number() const;
+
+      private:
+
+        /**
+         * Parse data received by a connection and hand its errors over to
+         * thread calling run as they are stored. Errors are handed over at
+         * most every poll period while more data is waiting, and as soon as
+         * no data is waiting so that last errors do not wait for next ones
+         * @param p_socket connection socket, it is closed at the end
+         * @param p_source source representing connection
+         */
+        inline
+        void treat_connection( int p_socket
+                             , valgrind_log_source & p_source
+                             );
+
+        /**
+         * Join threads of connections closed since last call, move errors
+         * received in content then call p_update. Lock is only held to take
+         * received errors and closed connections
+         * @param p_update function to call
+         */
+        inline
+        void update(const std::function<void()> & p_update);
+
+        valgrind_log_content & m_content;
+
+        int m_socket;
+
+        /**
+         * Protect open connections, received contents, node number and
+         * exception. Content is only modified by thread calling run so it
+         * does not need lock
+         */
+        std::mutex m_mutex;
+
+        std::set<int> m_connections;
+
+        /**
+         * Errors received by connections not yet moved in content, in order
+         * of reception
+         */
+        std::vector<std::unique_ptr<valgrind_log_content>> m_received_contents;
+
+        /**
+         * Threads of closed connections not yet joined
+         */
+        std::vector<std::thread::id> m_closed_threads;
+
+        /**
+         * First unexpected exception thrown by a connection thread
+         */
+        std::exception_ptr m_exception;
+
+        /**
+         * Threads of connections, only modified by thread calling run
+         */
+        std::vector<std::thread> m_threads;
+
+        uint64_t m_node_number;
+
+        static const int m_poll_period = 200;
+    };
+
+    //-------------------------------------------------------------------------
+    const int valgrind_log_listener::m_poll_period;
+
+    //-------------------------------------------------------------------------
+    valgrind_log_listener::valgrind_log_listener( const std::string & p_address
+                                                , valgrind_log_content & p_content
+                                                )
+    : m_content(p_content)
+    , m_socket(-1)
+    , m_node_number(0)
+    {
+        sockaddr_in l_address;
+        memset(&l_address, 0, sizeof(l_address));
+        l_address.sin_family = AF_INET;
+        l_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        std::string::size_type l_colon = p_address.rfind(':');
+        std::string l_port = std::string::npos == l_colon ? p_address : p_address.substr(l_colon + 1);
+        if(std::string::npos != l_colon && 1 != inet_pton(AF_INET, p_address.substr(0, l_colon).c_str(), &l_address.sin_addr))
+        {
+            throw quicky_exception::quicky_logic_exception("Invalid IPv4 address in \"" + p_address + "\"", __LINE__, __FILE__);
+        }
+        l_address.sin_port = htons(parse_number<uint16_t>(string_ref(l_port)));
+
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+        int l_reuse = 1;
+        if(-1 == m_socket
+           || setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &l_reuse, sizeof(l_reuse))
+           || bind(m_socket, reinterpret_cast<const sockaddr *>(&l_address), sizeof(l_address))
+           || listen(m_socket, SOMAXCONN)
+          )
+        {
+            std::string l_error = strerror(errno);
+            if(-1 != m_socket)
+            {
+                close(m_socket);
+            }
+            throw quicky_exception::quicky_runtime_exception("Unable to listen on \"" + p_address + "\": " + l_error, __LINE__, __FILE__);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_listener::~valgrind_log_listener()
+    {
+        close(m_socket);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_listener::run( unsigned int p_connection_number
+                              , const std::function<bool()> & p_interrupted
+                              , const std::function<void()> & p_update
+                              )
+    {
+        unsigned int l_accepted = 0;
+        bool l_stopped = false;
+        std::exception_ptr l_exception;
+        try
+        {
+            for(;;)
+            {
+                update(p_update);
+                bool l_accepting = !p_connection_number || l_accepted < p_connection_number;
+                {
+                    std::lock_guard<std::mutex> l_lock(m_mutex);
+                    if(m_exception)
+                    {
+                        l_stopped = true;
+                        break;
+                    }
+                    if(!l_accepting && m_connections.empty())
+                    {
+                        break;
+                    }
+                }
+                if(p_interrupted())
+                {
+                    l_stopped = true;
+                    break;
+                }
+                if(!l_accepting)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(m_poll_period));
+                    continue;
+                }
+                pollfd l_poll{m_socket, POLLIN, 0};
+                if(poll(&l_poll, 1, m_poll_period) <= 0)
+                {
+                    continue;
+                }
+                sockaddr_in l_peer;
+                socklen_t l_peer_size = sizeof(l_peer);
+                int l_connection = accept(m_socket, reinterpret_cast<sockaddr *>(&l_peer), &l_peer_size);
+                if(-1 == l_connection)
+                {
+                    continue;
+                }
+                ++l_accepted;
+                char l_peer_address[INET_ADDRSTRLEN] = "";
+                inet_ntop(AF_INET, &l_peer.sin_addr, l_peer_address, sizeof(l_peer_address));
+                // Sources are numbered in connections order
+                valgrind_log_source & l_source = m_content.add_source(std::string(l_peer_address) + ":" + std::to_string(ntohs(l_peer.sin_port)));
+                std::lock_guard<std::mutex> l_lock(m_mutex);
+                m_connections.insert(l_connection);
+                m_threads.emplace_back(&valgrind_log_listener::treat_connection, this, l_connection, std::ref(l_source));
+            }
+        }
+        catch(...)
+        {
+            l_exception = std::current_exception();
+            l_stopped = true;
+        }
+
+        if(l_stopped)
+        {
+            // Reading threads see end of stream
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            for(auto l_iter: m_connections)
+            {
+                shutdown(l_iter, SHUT_RDWR);
+            }
+        }
+        for(auto & l_iter: m_threads)
+        {
+            l_iter.join();
+        }
+        m_threads.clear();
+        {
+            // Threads are already joined, only their contents remain to move
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            m_closed_threads.clear();
+        }
+
+        // Errors received meanwhile are kept
+        if(!l_exception)
+        {
+            update(p_update);
+            l_exception = m_exception;
+        }
+        if(l_exception)
+        {
+            std::rethrow_exception(l_exception);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_listener::treat_connection( int p_socket
+                                           , valgrind_log_source & p_source
+                                           )
+    {
+        std::unique_ptr<valgrind_log_content> l_content{new valgrind_log_content()};
+        uint64_t l_node_number = 0;
+        std::string l_problem;
+        std::exception_ptr l_exception;
+        auto l_hand_over_time = std::chrono::steady_clock::now();
+        const auto l_error_stored = [&]()
+        {
+            auto l_now = std::chrono::steady_clock::now();
+            pollfd l_poll{p_socket, POLLIN, 0};
+            if(l_now - l_hand_over_time < std::chrono::milliseconds(m_poll_period) && poll(&l_poll, 1, 0) > 0)
+            {
+                return;
+            }
+            // Parser goes on filling emptied content
+            std::unique_ptr<valgrind_log_content> l_received{new valgrind_log_content()};
+            l_received->take(*l_content);
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            m_received_contents.push_back(std::move(l_received));
+            l_hand_over_time = l_now;
+        };
+        {
+            fd_streambuf l_buffer(p_socket, p_source.get_name());
+            std::istream l_stream(&l_buffer);
+            try
+            {
+                valgrind_log_parser l_parser(l_stream, p_source, *l_content, &l_node_number, l_error_stored);
+            }
+            catch(const quicky_exception::quicky_logic_exception & e)
+            {
+                l_problem = e.what();
+            }
+            catch(const quicky_exception::quicky_runtime_exception & e)
+            {
+                l_problem = e.what();
+            }
+            catch(...)
+            {
+                l_exception = std::current_exception();
+            }
+
+            // Connection is removed and its thread queued under the same lock
+            // so run cannot stop while a closed thread is still queued. Socket
+            // must not be shut down once closed by buffer
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            m_connections.erase(p_socket);
+            // Errors completely received are kept even if connection has been
+            // interrupted, like nodes already treated
+            if(!l_problem.empty())
+            {
+                std::cout << "Connection " << p_source.get_name() << " : " << l_problem << std::endl;
+            }
+            if(l_exception && !m_exception)
+            {
+                m_exception = l_exception;
+            }
+            // Remaining errors and error counts
+            m_received_contents.push_back(std::move(l_content));
+            // Thread is in threads list as it is added under lock
+            m_closed_threads.push_back(std::this_thread::get_id());
+            m_node_number += l_node_number;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_listener::update(const std::function<void()> & p_update)
+    {
+        std::vector<std::unique_ptr<valgrind_log_content>> l_contents;
+        std::vector<std::thread::id> l_closed_threads;
+        {
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            l_contents.swap(m_received_contents);
+            l_closed_threads.swap(m_closed_threads);
+        }
+        // Resources of a long running listener do not grow with the number
+        // of connections already closed
+        for(auto l_id: l_closed_threads)
+        {
+            auto l_iter = std::find_if(m_threads.begin(), m_threads.end(), [=](const std::thread & p_thread){return p_thread.get_id() == l_id;});
+            assert(m_threads.end() != l_iter);
+            l_iter->join();
+            m_threads.erase(l_iter);
+        }
+        for(auto & l_iter: l_contents)
+        {
+            m_content.take(*l_iter);
+        }
+        p_update();
+    }
+
+    //-------------------------------------------------------------------------
+    uint64_t
+    valgrind_log_listener::get_node_number() const
+    {
+        return m_node_number;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_LISTENER_H
+// EOF
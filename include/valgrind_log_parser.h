@@ -22,9 +22,23 @@
 #include "xmlParser.h"
 #include "quicky_exception.h"
 #include "valgrind_log_content.h"
+#include "xml_stream_reader.h"
+#include "valgrind_tag.h"
+#include "number_parser.h"
+#include "compressed_streambuf.h"
 #include <string>
 #include <cassert>
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cctype>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <sys/stat.h>
 
 namespace valgrind_log_tool
 {
@@ -32,113 +46,518 @@ namespace valgrind_log_tool
     {
       public:
 
+        /**
+         * Way the log file is read
+         * dom: whole document is loaded in memory by xmlParser then treated
+         * stream: document is treated while being read so memory used by
+         * parsing stays proportional to one error
+         * mapped: file is mapped in memory and treated like a stream. Texts
+         * without entities are directly referenced in the mapping instead of
+         * being copied, mapping is kept alive by content
+         * gzip and zstd compressed files are decompressed while being read
+         * so mapped mode treats them like stream mode
+         */
+        enum class t_input_mode
+        { dom
+        , stream
+        , mapped
+        };
+
+        /**
+         * Parse log and store its errors in content
+         * @param p_log_name name of log file
+         * @param p_content content to fill
+         * @param p_mode way the log file is read
+         * @param p_jobs number of threads used to parse a mapped file
+         */
         inline
         valgrind_log_parser( const std::string & p_log_name
                            , valgrind_log_content & p_content
+                           , t_input_mode p_mode = t_input_mode::stream
+                           , unsigned int p_jobs = 1
                            );
 
+        /**
+         * Parse log and store its errors in content
+         * @param p_source log file to parse, it can be owned by another
+         * content that will take errors later
+         * @param p_content content to fill
+         * @param p_mode way the log file is read
+         * @param p_jobs number of threads used to parse a mapped file
+         */
         inline
-        ~valgrind_log_parser();
+        valgrind_log_parser( valgrind_log_source & p_source
+                           , valgrind_log_content & p_content
+                           , t_input_mode p_mode = t_input_mode::stream
+                           , unsigned int p_jobs = 1
+                           );
+
+        /**
+         * Parse log read from a stream, for example a file that is still
+         * being written. Each error is stored in content as soon as it is
+         * closed
+         * @param p_stream stream to read
+         * @param p_source origin of stream, it can be owned by another
+         * content that will take errors later
+         * @param p_content content to fill
+         * @param p_node_number if not null, receives number of nodes
+         * treated, even when parsing fails before end of stream
+         * @param p_error_stored if set, function called each time an error
+         * has been stored in content. No frame or symbol of content is
+         * referenced by parser during call so content can be emptied by
+         * moving its errors in another content
+         */
+        inline
+        valgrind_log_parser( std::istream & p_stream
+                           , valgrind_log_source & p_source
+                           , valgrind_log_content & p_content
+                           , uint64_t * p_node_number = nullptr
+                           , const std::function<void()> & p_error_stored = nullptr
+                           );
+
+        /**
+         * @return number of nodes that have been treated
+         */
+        inline
+        uint64_t get_node_number() const;
 
       private:
 
+        /**
+         * Prepare parser without parsing anything
+         * @param p_content content to fill
+         */
+        inline explicit
+        valgrind_log_parser(valgrind_log_content & p_content);
+
+        inline
+        void parse_dom(const std::string & p_log_name);
+
+        inline
+        void parse_stream(const std::string & p_log_name);
+
+        /**
+         * Parse a compressed file. It is decompressed while being read
+         * except for dom mode that needs the whole document in memory
+         * @param p_log_name name of log file
+         * @param p_format compression format
+         * @param p_dom true if document should be loaded by xmlParser
+         */
+        inline
+        void parse_compressed( const std::string & p_log_name
+                             , compressed_streambuf::t_format p_format
+                             , bool p_dom
+                             );
+
+        /**
+         * Throw an exception describing xmlParser error if any
+         * @param p_result result of xmlParser
+         * @param p_log_name name of log file
+         */
+        inline static
+        void check_dom_result( const XMLResults & p_result
+                             , const std::string & p_log_name
+                             );
+
+        /**
+         * Map log in memory and parse it. A log that is not a regular file,
+         * like a pipe, has no size to map and is parsed as a stream
+         * @param p_log_name name of log file
+         * @param p_jobs maximum number of threads
+         */
+        inline
+        void parse_mapped( const std::string & p_log_name
+                         , unsigned int p_jobs
+                         );
+
+        /**
+         * Split document at top level error nodes and parse parts in
+         * parallel, each one in its own content, then move contents in order
+         * into parser content
+         * @param p_begin first character of document
+         * @param p_end end of document
+         * @param p_log_name name of log file
+         * @param p_jobs maximum number of threads
+         * @return false if document has not been parsed because it cannot be
+         * split or because a part is not valid. In this case content is
+         * unchanged and document should be parsed sequentially to report
+         * errors like a sequential parsing would do
+         */
+        inline
+        bool parse_parallel( const char * p_begin
+                           , const char * p_end
+                           , const std::string & p_log_name
+                           , unsigned int p_jobs
+                           );
+
+        /**
+         * Search start of next error node
+         * @param p_begin position where search starts
+         * @param p_end end of document
+         * @return position of error node or p_end if there is none
+         */
+        inline static
+        const char * find_error_node( const char * p_begin
+                                    , const char * p_end
+                                    );
+
+        inline
+        void parse(xml_stream_reader & p_reader);
+
+        /**
+         * Replay DOM node as the sequence of events a stream would produce
+         * @param p_node DOM node
+         */
+        inline
+        void walk(const XMLNode & p_node);
+
+        inline
+        void start_node(const string_ref & p_name);
+
+        inline
+        void end_node();
+
+        /**
+         * Append text to current node text
+         * @param p_text text to append
+         * @param p_persistent true if p_text characters stay valid as long as
+         * content, otherwise they are copied
+         */
+        inline
+        void append_text( const string_ref & p_text
+                        , bool p_persistent
+                        );
+
+        /**
+         * Return text of current node without leading and trailing spaces
+         */
+        inline
+        string_ref get_text() const;
+
+        /**
+         * Return text of current node without leading and trailing spaces,
+         * copying it in content if needed so that it lives as long as content
+         */
+        inline
+        string_ref keep_text();
+
+        /**
+         * Intern text of node being treated in content symbols
+         * @return id of symbol
+         */
+        inline
+        uint32_t keep_symbol();
+
+        /**
+         * @return tag of parent of node being treated
+         */
+        inline
+        valgrind_tag get_parent() const;
+
+        inline
+        void default_treat();
+
         inline
-        void treat(const XMLNode & p_node);
+        void ignore_treat();
 
         inline
-        void default_treat(const XMLNode & p_node);
+        void treat_pid();
 
         inline
-        void ignore_treat(const XMLNode & p_node);
+        void start_error();
 
         inline
-        void treat_error(const XMLNode & p_node);
+        void treat_error();
 
         inline
-        void treat_errorcounts(const XMLNode & p_node);
+        void treat_unique();
 
         inline
-        void treat_unique(const XMLNode & p_node);
+        void treat_tid();
 
         inline
-        void treat_tid(const XMLNode & p_node);
+        void treat_what();
 
         inline
-        void treat_what(const XMLNode & p_node);
+        void treat_aux_what();
 
         inline
-        void treat_aux_what(const XMLNode & p_node);
+        void treat_kind();
 
         inline
-        void treat_kind(const XMLNode & p_node);
+        void start_xwhat();
 
         inline
-        void treat_xwhat(const XMLNode & p_node);
+        void treat_xwhat();
 
         inline
-        void treat_frame(const XMLNode & p_node);
+        void start_frame();
 
         inline
-        void treat_ip(const XMLNode & p_node);
+        void treat_frame();
 
         inline
-        void treat_obj(const XMLNode & p_node);
+        void treat_ip();
 
         inline
-        void treat_fn(const XMLNode & p_node);
+        void treat_obj();
 
         inline
-        void treat_dir(const XMLNode & p_node);
+        void treat_fn();
 
         inline
-        void treat_file(const XMLNode & p_node);
+        void treat_dir();
 
         inline
-        void treat_line(const XMLNode & p_node);
+        void treat_file();
 
         inline
-        void treat_text(const XMLNode & p_node);
+        void treat_line();
 
         inline
-        void treat_leakedbytes(const XMLNode & p_node);
+        void treat_text();
 
         inline
-        void treat_leakedblocks(const XMLNode & p_node);
+        void treat_leakedbytes();
 
         inline
-        void treat_pair(const XMLNode & p_node);
+        void treat_leakedblocks();
 
         inline
-        void treat_count(const XMLNode & p_node);
+        void start_pair();
 
-        typedef void (valgrind_log_parser::*t_method)(const XMLNode &);
-        typedef std::map<std::string, t_method> t_name_methods;
-        t_name_methods m_methods;
+        inline
+        void treat_pair();
 
-        valgrind_error * m_current_error;
-        valgrind_xwhat * m_current_xwhat;
-        valgrind_frame * m_current_frame;
+        inline
+        void treat_count();
+
+        typedef void (valgrind_log_parser::*t_method)();
+
+        /**
+         * Define how a node is treated
+         * @param p_tag node tag
+         * @param p_parents set of tags of nodes that can contain this node
+         * @param p_start_method method called when node is opened
+         * @param p_end_method method called when node is closed
+         */
+        inline
+        void set_methods( valgrind_tag p_tag
+                        , uint32_t p_parents
+                        , t_method p_start_method
+                        , t_method p_end_method
+                        );
+
+        /**
+         * Methods called when node is opened and when it is closed indexed
+         * by node tag
+         */
+        typedef std::pair<t_method, t_method> t_methods;
+        t_methods m_methods[valgrind_tag_number];
+
+        /**
+         * Set of tags allowed as parent indexed by node tag
+         */
+        uint32_t m_parents[valgrind_tag_number];
+
+        /**
+         * Tags of open nodes, content of ignored nodes is not stored
+         */
+        std::vector<valgrind_tag> m_stack;
+
+        /**
+         * Depth of nodes in ignored node, 1 for ignored node itself and 0
+         * if no node is ignored
+         */
+        unsigned int m_ignore_depth;
+
+        /**
+         * Text of node being treated
+         */
+        string_ref m_text;
+        bool m_text_persistent;
+
+        /**
+         * Storage of node text when it is made of several parts
+         */
+        std::string m_text_buffer;
+
+        /**
+         * Error being read, it is stored in content once complete
+         */
+        valgrind_error m_current_error;
+        valgrind_xwhat m_current_xwhat;
+        /**
+         * Frame being read, it is interned in content once complete
+         */
+        valgrind_frame m_current_frame;
+
+        /**
+         * Frame indexes of error being read, copied in content once complete
+         */
+        std::vector<uint32_t> m_current_stack;
         std::pair<uint64_t, uint32_t> m_current_pair;
 
         valgrind_log_content & m_content;
+
+        /**
+         * Log file being parsed
+         */
+        valgrind_log_source * m_source;
+
+        uint64_t m_node_number;
+
+        /**
+         * Function called each time an error has been stored, may be empty
+         */
+        std::function<void()> m_error_stored;
+
+        /**
+         * Minimum size of document part given to a thread
+         */
+        static const size_t m_min_part_size = 1 << 20;
     };
 
     //-------------------------------------------------------------------------
     valgrind_log_parser::valgrind_log_parser( const std::string & p_log_name
                                             , valgrind_log_content & p_content
+                                            , t_input_mode p_mode
+                                            , unsigned int p_jobs
+                                            )
+    : valgrind_log_parser(p_content.add_source(p_log_name), p_content, p_mode, p_jobs)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_parser::valgrind_log_parser( valgrind_log_source & p_source
+                                            , valgrind_log_content & p_content
+                                            , t_input_mode p_mode
+                                            , unsigned int p_jobs
+                                            )
+    : valgrind_log_parser(p_content)
+    {
+        m_source = &p_source;
+        const std::string & l_log_name = p_source.get_name();
+        compressed_streambuf::t_format l_format = compressed_streambuf::get_format(l_log_name);
+        if(compressed_streambuf::t_format::none != l_format)
+        {
+            parse_compressed(l_log_name, l_format, t_input_mode::dom == p_mode);
+            return;
+        }
+        switch(p_mode)
+        {
+            case t_input_mode::dom:
+                parse_dom(l_log_name);
+                break;
+            case t_input_mode::stream:
+                parse_stream(l_log_name);
+                break;
+            case t_input_mode::mapped:
+                parse_mapped(l_log_name, p_jobs);
+                break;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_parser::valgrind_log_parser( std::istream & p_stream
+                                            , valgrind_log_source & p_source
+                                            , valgrind_log_content & p_content
+                                            , uint64_t * p_node_number
+                                            , const std::function<void()> & p_error_stored
                                             )
-    : m_current_error(nullptr)
-    , m_current_xwhat(nullptr)
-    , m_current_frame(nullptr)
+    : valgrind_log_parser(p_content)
+    {
+        m_source = &p_source;
+        m_error_stored = p_error_stored;
+        try
+        {
+            xml_stream_reader l_reader(p_stream, p_source.get_name());
+            parse(l_reader);
+        }
+        catch(...)
+        {
+            if(p_node_number)
+            {
+                *p_node_number = m_node_number;
+            }
+            throw;
+        }
+        if(p_node_number)
+        {
+            *p_node_number = m_node_number;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_parser::valgrind_log_parser(valgrind_log_content & p_content)
+    : m_ignore_depth(0)
+    , m_text_persistent(false)
     , m_current_pair{0,0}
     , m_content(p_content)
+    , m_source(nullptr)
+    , m_node_number(0)
+    {
+        // Allowed parents of each node
+        const uint32_t l_root = get_valgrind_tag_mask(valgrind_tag::valgrindoutput);
+        const uint32_t l_error = get_valgrind_tag_mask(valgrind_tag::error);
+        const uint32_t l_stack = get_valgrind_tag_mask(valgrind_tag::stack);
+        const uint32_t l_frame = get_valgrind_tag_mask(valgrind_tag::frame);
+        const uint32_t l_xwhat = get_valgrind_tag_mask(valgrind_tag::xwhat);
+        const uint32_t l_errorcounts = get_valgrind_tag_mask(valgrind_tag::errorcounts);
+        const uint32_t l_pair = get_valgrind_tag_mask(valgrind_tag::pair);
+
+        set_methods(valgrind_tag::valgrindoutput, 0, &valgrind_log_parser::default_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::protocolversion, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::protocoltool, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::preamble, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::pid, l_root, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_pid);
+        set_methods(valgrind_tag::ppid, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::tool, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::args, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::status, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::error, l_root, &valgrind_log_parser::start_error, &valgrind_log_parser::treat_error);
+        set_methods(valgrind_tag::unique, l_error | l_pair, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_unique);
+        set_methods(valgrind_tag::tid, l_error, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_tid);
+        set_methods(valgrind_tag::kind, l_error, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_kind);
+        set_methods(valgrind_tag::what, l_error, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_what);
+        set_methods(valgrind_tag::auxwhat, l_error, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_aux_what);
+        set_methods(valgrind_tag::stack, l_error, &valgrind_log_parser::default_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::frame, l_stack, &valgrind_log_parser::start_frame, &valgrind_log_parser::treat_frame);
+        set_methods(valgrind_tag::ip, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_ip);
+        set_methods(valgrind_tag::obj, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_obj);
+        set_methods(valgrind_tag::fn, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_fn);
+        set_methods(valgrind_tag::dir, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_dir);
+        set_methods(valgrind_tag::file, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_file);
+        set_methods(valgrind_tag::line, l_frame, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_line);
+        set_methods(valgrind_tag::xwhat, l_error, &valgrind_log_parser::start_xwhat, &valgrind_log_parser::treat_xwhat);
+        set_methods(valgrind_tag::text, l_xwhat, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_text);
+        set_methods(valgrind_tag::leakedbytes, l_xwhat, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_leakedbytes);
+        set_methods(valgrind_tag::leakedblocks, l_xwhat, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_leakedblocks);
+        set_methods(valgrind_tag::pair, l_errorcounts, &valgrind_log_parser::start_pair, &valgrind_log_parser::treat_pair);
+        set_methods(valgrind_tag::count, l_pair, &valgrind_log_parser::default_treat, &valgrind_log_parser::treat_count);
+        set_methods(valgrind_tag::errorcounts, l_root, &valgrind_log_parser::default_treat, &valgrind_log_parser::default_treat);
+        set_methods(valgrind_tag::suppcounts, l_root, &valgrind_log_parser::ignore_treat, &valgrind_log_parser::default_treat);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::parse_dom(const std::string & p_log_name)
     {
         XMLResults l_err= {eXMLErrorNone,0,0};
         XMLNode l_node = XMLNode::parseFile( p_log_name.c_str(), "valgrindoutput", &l_err);
+        check_dom_result(l_err, p_log_name);
+        walk(l_node);
+    }
 
-        if(eXMLErrorNone != l_err.error)
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::check_dom_result( const XMLResults & p_result
+                                         , const std::string & p_log_name
+                                         )
+    {
+        if(eXMLErrorNone != p_result.error)
         {
-            if(eXMLErrorFileNotFound == l_err.error)
+            if(eXMLErrorFileNotFound == p_result.error)
             {
                 throw quicky_exception::quicky_runtime_exception( "File \"" + p_log_name + "\" not found"
                                                                 , __LINE__
@@ -147,333 +566,570 @@ namespace valgrind_log_tool
             }
             else
             {
-                std::string l_error_msg = XMLNode::getError(l_err.error);
-                throw quicky_exception::quicky_logic_exception( "\"" + l_error_msg + "\" at line " + std::to_string(l_err.nLine) + " and column " + std::to_string(l_err.nColumn) + " of file \"" + p_log_name + "\""
+                std::string l_error_msg = XMLNode::getError(p_result.error);
+                throw quicky_exception::quicky_logic_exception( "\"" + l_error_msg + "\" at line " + std::to_string(p_result.nLine) + " and column " + std::to_string(p_result.nColumn) + " of file \"" + p_log_name + "\""
                                                               , __LINE__
                                                               , __FILE__
                                                               );
             }
         }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::parse_stream(const std::string & p_log_name)
+    {
+        std::ifstream l_stream(p_log_name, std::ios::in | std::ios::binary);
+        if(!l_stream.is_open())
+        {
+            throw quicky_exception::quicky_runtime_exception( "File \"" + p_log_name + "\" not found"
+                                                            , __LINE__
+                                                            , __FILE__
+                                                            );
+        }
 
-        m_methods.insert(t_name_methods::value_type("valgrindoutput", &valgrind_log_parser::default_treat));
-        m_methods.insert(t_name_methods::value_type("protocolversion", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("protocoltool", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("preamble", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("pid", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("ppid", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("tool", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("args", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("status", &valgrind_log_parser::ignore_treat));
-        m_methods.insert(t_name_methods::value_type("error", &valgrind_log_parser::treat_error));
-        m_methods.insert(t_name_methods::value_type("unique", &valgrind_log_parser::treat_unique));
-        m_methods.insert(t_name_methods::value_type("tid", &valgrind_log_parser::treat_tid));
-        m_methods.insert(t_name_methods::value_type("kind", &valgrind_log_parser::treat_kind));
-        m_methods.insert(t_name_methods::value_type("what", &valgrind_log_parser::treat_what));
-        m_methods.insert(t_name_methods::value_type("auxwhat", &valgrind_log_parser::treat_aux_what));
-        m_methods.insert(t_name_methods::value_type("stack", &valgrind_log_parser::default_treat));
-        m_methods.insert(t_name_methods::value_type("frame", &valgrind_log_parser::treat_frame));
-        m_methods.insert(t_name_methods::value_type("ip", &valgrind_log_parser::treat_ip));
-        m_methods.insert(t_name_methods::value_type("obj", &valgrind_log_parser::treat_obj));
-        m_methods.insert(t_name_methods::value_type("fn", &valgrind_log_parser::treat_fn));
-        m_methods.insert(t_name_methods::value_type("dir", &valgrind_log_parser::treat_dir));
-        m_methods.insert(t_name_methods::value_type("file", &valgrind_log_parser::treat_file));
-        m_methods.insert(t_name_methods::value_type("line", &valgrind_log_parser::treat_line));
-        m_methods.insert(t_name_methods::value_type("xwhat", &valgrind_log_parser::treat_xwhat));
-        m_methods.insert(t_name_methods::value_type("text", &valgrind_log_parser::treat_text));
-        m_methods.insert(t_name_methods::value_type("leakedbytes", &valgrind_log_parser::treat_leakedbytes));
-        m_methods.insert(t_name_methods::value_type("leakedblocks", &valgrind_log_parser::treat_leakedblocks));
-        m_methods.insert(t_name_methods::value_type("pair", &valgrind_log_parser::treat_pair));
-        m_methods.insert(t_name_methods::value_type("count", &valgrind_log_parser::treat_count));
-        m_methods.insert(t_name_methods::value_type("errorcounts", &valgrind_log_parser::treat_errorcounts));
-        m_methods.insert(t_name_methods::value_type("suppcounts", &valgrind_log_parser::ignore_treat));
-
-        treat(l_node);
-    }
-
-    //-------------------------------------------------------------------------
-    void
-    valgrind_log_parser::treat(const XMLNode & p_node)
-    {
-        std::string l_node_name{p_node.getName()};
-
-        t_name_methods::const_iterator l_method_iter = m_methods.find(l_node_name);
-        if(m_methods.end() != l_method_iter)
-        {
-            (this->*(l_method_iter->second))(p_node);
+        xml_stream_reader l_reader(l_stream, p_log_name);
+        parse(l_reader);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::parse_compressed( const std::string & p_log_name
+                                         , compressed_streambuf::t_format p_format
+                                         , bool p_dom
+                                         )
+    {
+        compressed_streambuf l_buffer(p_log_name, p_format);
+        if(p_dom)
+        {
+            std::string l_document{std::istreambuf_iterator<char>(&l_buffer), std::istreambuf_iterator<char>()};
+            XMLResults l_err= {eXMLErrorNone,0,0};
+            XMLNode l_node = XMLNode::parseString(l_document.c_str(), "valgrindoutput", &l_err);
+            check_dom_result(l_err, p_log_name);
+            walk(l_node);
         }
         else
         {
-            throw quicky_exception::quicky_logic_exception("Unsupported type of node \"" + l_node_name + "\"", __LINE__, __FILE__);
+            std::istream l_stream(&l_buffer);
+            xml_stream_reader l_reader(l_stream, p_log_name);
+            parse(l_reader);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::parse_mapped( const std::string & p_log_name
+                                     , unsigned int p_jobs
+                                     )
+    {
+        struct stat l_stat;
+        if(!stat(p_log_name.c_str(), &l_stat) && !S_ISREG(l_stat.st_mode))
+        {
+            parse_stream(p_log_name);
+            return;
+        }
+        std::unique_ptr<const mapped_file> l_mapping{new mapped_file(p_log_name)};
+        const char * l_begin = l_mapping->begin();
+        const char * l_end = l_mapping->end();
+        m_content.add_mapping(std::move(l_mapping));
+        if(p_jobs > 1 && parse_parallel(l_begin, l_end, p_log_name, p_jobs))
+        {
+            return;
+        }
+        xml_stream_reader l_reader(l_begin, l_end, p_log_name);
+        parse(l_reader);
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    valgrind_log_parser::parse_parallel( const char * p_begin
+                                       , const char * p_end
+                                       , const std::string & p_log_name
+                                       , unsigned int p_jobs
+                                       )
+    {
+        size_t l_size = p_end - p_begin;
+        size_t l_part_number = std::min(static_cast<size_t>(p_jobs), l_size / m_min_part_size);
+
+        // Parts start at the first error node following evenly spaced positions
+        std::vector<const char *> l_bounds{p_begin};
+        for(size_t l_index = 1; l_index < l_part_number; ++l_index)
+        {
+            const char * l_bound = find_error_node(std::max(p_begin + l_size * l_index / l_part_number, l_bounds.back() + 1), p_end);
+            if(p_end == l_bound)
+            {
+                break;
+            }
+            l_bounds.push_back(l_bound);
+        }
+        l_bounds.push_back(p_end);
+        l_part_number = l_bounds.size() - 1;
+        if(l_part_number < 2)
+        {
+            return false;
+        }
+
+        // Contents are created before threads as vector must not be
+        // reallocated while threads use it
+        std::vector<std::unique_ptr<valgrind_log_content>> l_contents;
+        for(size_t l_index = 0; l_index < l_part_number; ++l_index)
+        {
+            l_contents.emplace_back(new valgrind_log_content());
+        }
+        std::vector<uint64_t> l_node_numbers(l_part_number, 0);
+        // Not a std::vector<bool> whose elements cannot be set concurrently
+        std::vector<char> l_valids(l_part_number, false);
+        std::vector<std::thread> l_threads;
+        for(size_t l_index = 0; l_index < l_part_number; ++l_index)
+        {
+            l_threads.emplace_back([&, l_index]()
+                                   {
+                                       try
+                                       {
+                                           bool l_last = l_part_number == l_index + 1;
+                                           valgrind_log_parser l_parser(*l_contents[l_index]);
+                                           l_parser.m_source = m_source;
+                                           xml_stream_reader l_reader(l_bounds[l_index], l_bounds[l_index + 1], p_log_name, l_index ? "valgrindoutput" : "", l_last);
+                                           if(l_index)
+                                           {
+                                               l_parser.m_stack.push_back(valgrind_tag::valgrindoutput);
+                                           }
+                                           l_parser.parse(l_reader);
+                                           // Apart from last one, parts must end inside root node
+                                           l_valids[l_index] = l_last ? l_parser.m_stack.empty() : 1 == l_parser.m_stack.size();
+                                           l_node_numbers[l_index] = l_parser.m_node_number;
+                                       }
+                                       catch(...)
+                                       {
+                                           // Part stays not valid, sequential parsing will report the error
+                                       }
+                                   }
+                                  );
+        }
+        for(auto & l_iter: l_threads)
+        {
+            l_iter.join();
+        }
+
+        for(size_t l_index = 0; l_index < l_part_number; ++l_index)
+        {
+            if(!l_valids[l_index])
+            {
+                return false;
+            }
+        }
+        for(size_t l_index = 0; l_index < l_part_number; ++l_index)
+        {
+            m_content.take(*l_contents[l_index]);
+            m_node_number += l_node_numbers[l_index];
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    valgrind_log_parser::find_error_node( const char * p_begin
+                                        , const char * p_end
+                                        )
+    {
+        const char l_pattern[] = "<error>";
+        const size_t l_pattern_size = sizeof(l_pattern) - 1;
+        const char * l_iter = p_begin;
+        while(nullptr != (l_iter = static_cast<const char *>(memchr(l_iter, '<', p_end - l_iter))))
+        {
+            if(static_cast<size_t>(p_end - l_iter) < l_pattern_size)
+            {
+                break;
+            }
+            if(!memcmp(l_iter, l_pattern, l_pattern_size))
+            {
+                return l_iter;
+            }
+            ++l_iter;
+        }
+        return p_end;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::parse(xml_stream_reader & p_reader)
+    {
+        for(;;)
+        {
+            switch(p_reader.next())
+            {
+                case xml_stream_reader::t_event::start_element:
+                    start_node(p_reader.get_name());
+                    break;
+                case xml_stream_reader::t_event::text:
+                    append_text(p_reader.get_text(), p_reader.is_text_persistent());
+                    break;
+                case xml_stream_reader::t_event::end_element:
+                    end_node();
+                    break;
+                case xml_stream_reader::t_event::end_of_document:
+                    return;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::walk(const XMLNode & p_node)
+    {
+        const char * l_name = p_node.getName();
+        start_node(string_ref(l_name, strlen(l_name)));
+        // Content of ignored nodes is not replayed
+        if(!m_ignore_depth)
+        {
+            int l_nb_text = p_node.nText();
+            for(int l_index = 0; l_index < l_nb_text; ++l_index)
+            {
+                const char * l_text = p_node.getText(l_index);
+                append_text(string_ref(l_text, strlen(l_text)), false);
+            }
+            int l_nb_child = p_node.nChildNode();
+            for(int l_index = 0; l_index < l_nb_child; ++l_index)
+            {
+                walk(p_node.getChildNode(l_index));
+            }
+        }
+        end_node();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::start_node(const string_ref & p_name)
+    {
+        ++m_node_number;
+        if(m_ignore_depth)
+        {
+            ++m_ignore_depth;
+            return;
+        }
+        valgrind_tag l_tag = get_valgrind_tag(p_name);
+        if(valgrind_tag::unknown == l_tag)
+        {
+            throw quicky_exception::quicky_logic_exception("Unsupported type of node \"" + p_name.str() + "\"", __LINE__, __FILE__);
+        }
+        unsigned int l_tag_index = static_cast<unsigned int>(l_tag);
+        if(m_stack.empty())
+        {
+            if(valgrind_tag::valgrindoutput != l_tag)
+            {
+                throw quicky_exception::quicky_logic_exception("Root node \"" + p_name.str() + "\" is not \"valgrindoutput\"", __LINE__, __FILE__);
+            }
+        }
+        else if(!(m_parents[l_tag_index] & get_valgrind_tag_mask(m_stack.back())))
+        {
+            throw quicky_exception::quicky_logic_exception("Unexpected node \"" + p_name.str() + "\" in node \"" + get_valgrind_tag_name(m_stack.back()) + "\"", __LINE__, __FILE__);
+        }
+
+        m_stack.push_back(l_tag);
+        m_text = string_ref();
+        (this->*(m_methods[l_tag_index].first))();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::end_node()
+    {
+        assert(!m_stack.empty());
+        // Ignored node itself is in the stack, not its content
+        if(m_ignore_depth && --m_ignore_depth)
+        {
+            return;
         }
+        (this->*(m_methods[static_cast<unsigned int>(m_stack.back())].second))();
+        m_stack.pop_back();
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::default_treat(const XMLNode & p_node)
+    valgrind_log_parser::set_methods( valgrind_tag p_tag
+                                    , uint32_t p_parents
+                                    , t_method p_start_method
+                                    , t_method p_end_method
+                                    )
+    {
+        m_methods[static_cast<unsigned int>(p_tag)] = t_methods(p_start_method, p_end_method);
+        m_parents[static_cast<unsigned int>(p_tag)] = p_parents;
+    }
+
+    //-------------------------------------------------------------------------
+    uint64_t
+    valgrind_log_parser::get_node_number() const
+    {
+        return m_node_number;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::append_text( const string_ref & p_text
+                                    , bool p_persistent
+                                    )
+    {
+        if(m_ignore_depth)
+        {
+            return;
+        }
+        if(m_text.empty() && p_persistent)
+        {
+            m_text = p_text;
+            m_text_persistent = true;
+            return;
+        }
+        // Text that is not persistent can be overwritten by next read so it is copied
+        if(m_text.data() != m_text_buffer.data())
+        {
+            m_text_buffer.assign(m_text.data(), m_text.size());
+        }
+        m_text_buffer.append(p_text.data(), p_text.size());
+        m_text = string_ref(m_text_buffer);
+        m_text_persistent = false;
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref
+    valgrind_log_parser::get_text() const
     {
-        int l_nb_child = p_node.nChildNode();
-        for(int l_index = 0; l_index < l_nb_child; ++l_index)
+        const char * l_begin = m_text.begin();
+        const char * l_end = m_text.end();
+        while(l_begin < l_end && isspace(static_cast<unsigned char>(*l_begin)))
         {
-            treat(p_node.getChildNode(l_index));
+            ++l_begin;
         }
+        while(l_begin < l_end && isspace(static_cast<unsigned char>(l_end[-1])))
+        {
+            --l_end;
+        }
+        return string_ref(l_begin, l_end - l_begin);
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref
+    valgrind_log_parser::keep_text()
+    {
+        return m_text_persistent ? get_text() : m_content.store_string(get_text());
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_parser::keep_symbol()
+    {
+        return m_content.add_symbol(get_text(), m_text_persistent);
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_tag
+    valgrind_log_parser::get_parent() const
+    {
+        assert(m_stack.size() > 1);
+        return m_stack[m_stack.size() - 2];
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::ignore_treat(const XMLNode & p_node)
+    valgrind_log_parser::default_treat()
     {
         // Do nothing
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_error(const XMLNode & p_node)
+    valgrind_log_parser::ignore_treat()
     {
-        m_current_error = new valgrind_error();
-        default_treat(p_node);
-        m_content.add_error(*m_current_error);
-        m_current_error = nullptr;
+        m_ignore_depth = 1;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_errorcounts(const XMLNode & p_node)
+    valgrind_log_parser::treat_pid()
     {
-        default_treat(p_node);
+        m_source->set_pid(parse_number<uint64_t>(get_text()));
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_unique(const XMLNode & p_node)
+    valgrind_log_parser::start_error()
     {
-        assert(!p_node.nChildNode());
-        assert(1 == p_node.nText());
-        uint64_t l_unique = std::stoull(p_node.getText(), nullptr, 0);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        if("error" == l_parent_name)
+        m_current_error = valgrind_error();
+        m_current_error.set_source(*m_source);
+        m_current_stack.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::treat_error()
+    {
+        m_content.add_error(m_current_error, m_current_stack);
+        if(m_error_stored)
         {
-            assert(m_current_error);
-            m_current_error->set_unique(l_unique);
+            m_error_stored();
         }
-        else if("pair" == l_parent_name)
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::treat_unique()
+    {
+        uint64_t l_unique = parse_number<uint64_t>(get_text());
+        if(valgrind_tag::error == get_parent())
         {
-            m_current_pair.first = l_unique;
+            m_current_error.set_unique(l_unique);
         }
         else
         {
-            throw quicky_exception::quicky_logic_exception("Unsupported parent name \"" + l_parent_name + "\" for node \"" + p_node.getName() + "\"", __LINE__, __FILE__);
+            assert(valgrind_tag::pair == get_parent());
+            m_current_pair.first = l_unique;
         }
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_tid(const XMLNode & p_node)
+    valgrind_log_parser::treat_tid()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_error);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("error" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_error->set_tid(std::stoull(p_node.getText(), nullptr, 0));
+        m_current_error.set_tid(parse_number<uint64_t>(get_text()));
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_kind(const XMLNode & p_node)
+    valgrind_log_parser::treat_kind()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_error);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("error" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_error->set_kind(p_node.getText());
+        m_current_error.set_kind(keep_symbol());
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_what(const XMLNode & p_node)
+    valgrind_log_parser::treat_what()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_error);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("error" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_error->set_what(p_node.getText());
+        m_current_error.set_what(keep_text());
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_aux_what(const XMLNode & p_node)
+    valgrind_log_parser::treat_aux_what()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_error);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("error" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_error->set_aux_what(p_node.getText());
+        m_current_error.set_aux_what(keep_text());
     }
 
     //-------------------------------------------------------------------------
-    valgrind_log_parser::~valgrind_log_parser()
+    void
+    valgrind_log_parser::start_frame()
     {
+        m_current_frame = valgrind_frame();
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_frame(const XMLNode & p_node)
+    valgrind_log_parser::treat_frame()
     {
-        assert(m_current_error);
-        m_current_frame = new valgrind_frame();
-        default_treat(p_node);
-        m_current_error->add_frame(*m_current_frame);
-        m_current_frame = nullptr;
+        m_current_stack.push_back(m_content.add_frame(m_current_frame));
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_ip(const XMLNode & p_node)
+    valgrind_log_parser::treat_ip()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_ip(std::stoull(p_node.getText(), nullptr, 0));
+        m_current_frame.set_ip(parse_number<uint64_t>(get_text()));
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_obj(const XMLNode & p_node)
+    valgrind_log_parser::treat_obj()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_obj(p_node.getText());
+        m_current_frame.set_obj(keep_symbol());
 
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_fn(const XMLNode & p_node)
+    valgrind_log_parser::treat_fn()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_fn(p_node.getText());
+        m_current_frame.set_fn(keep_symbol());
 
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_dir(const XMLNode & p_node)
+    valgrind_log_parser::treat_dir()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_dir(p_node.getText());
+        m_current_frame.set_dir(keep_symbol());
 
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_file(const XMLNode & p_node)
+    valgrind_log_parser::treat_file()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_file(p_node.getText());
+        m_current_frame.set_file(keep_symbol());
 
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_line(const XMLNode & p_node)
+    valgrind_log_parser::treat_line()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_frame);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("frame" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_frame->set_line(std::stoul(p_node.getText(), nullptr, 0));
+        m_current_frame.set_line(parse_number<uint32_t>(get_text()));
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_xwhat(const XMLNode & p_node)
+    valgrind_log_parser::start_xwhat()
     {
-        assert(!m_current_xwhat);
-        m_current_xwhat = new valgrind_xwhat();
-        default_treat(p_node);
-        m_current_error->set_xwhat(*m_current_xwhat);
-        m_current_xwhat = nullptr;
+        m_current_xwhat = valgrind_xwhat();
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_text(const XMLNode & p_node)
+    valgrind_log_parser::treat_xwhat()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_xwhat);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("xwhat" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_xwhat->set_text(p_node.getText());
+        m_current_error.set_xwhat(m_current_xwhat);
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_leakedbytes(const XMLNode & p_node)
+    valgrind_log_parser::treat_text()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_xwhat);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("xwhat" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_xwhat->set_leaked_bytes(std::stoul(p_node.getText(), nullptr, 0));
+        m_current_xwhat.set_text(keep_text());
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_leakedblocks(const XMLNode & p_node)
+    valgrind_log_parser::treat_leakedbytes()
     {
-        assert(!p_node.nChildNode());
-        assert(m_current_xwhat);
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("xwhat" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_xwhat->set_leaked_blocks(std::stoul(p_node.getText(), nullptr, 0));
+        m_current_xwhat.set_leaked_bytes(parse_number<uint64_t>(get_text()));
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::treat_leakedblocks()
+    {
+        m_current_xwhat.set_leaked_blocks(parse_number<uint64_t>(get_text()));
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_parser::start_pair()
+    {
+        m_current_pair = {0, 0};
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_pair(const XMLNode & p_node)
+    valgrind_log_parser::treat_pair()
     {
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("errorcounts" == l_parent_name);
-        default_treat(p_node);
-        m_content.add_error_count(m_current_pair.first, m_current_pair.second);
+        m_content.add_error_count(*m_source, m_current_pair.first, m_current_pair.second);
         m_current_pair = {0, 0};
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_log_parser::treat_count(const XMLNode & p_node)
+    valgrind_log_parser::treat_count()
     {
-        assert(!p_node.nChildNode());
-        std::string l_parent_name = p_node.getParentNode().getName();
-        assert("pair" == l_parent_name);
-        assert(1 == p_node.nText());
-        m_current_pair.second = std::stoul(p_node.getText(), nullptr, 0);
+        m_current_pair.second = parse_number<uint32_t>(get_text());
     }
 
 }
 #endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_PARSER_H
-// EOF
\ No newline at end of file
+// EOF
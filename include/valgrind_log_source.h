@@ -0,0 +1,110 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_LOG_SOURCE_H
+#define VALGRIND_LOG_TOOL_VALGRIND_LOG_SOURCE_H
+
+#include <cinttypes>
+#include <string>
+#include <atomic>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Log file errors come from
+     */
+    class valgrind_log_source
+    {
+      public:
+
+        /**
+         * @param p_index position of source in content
+         * @param p_name name of log file
+         */
+        inline
+        valgrind_log_source( unsigned int p_index
+                           , const std::string & p_name
+                           );
+
+        inline
+        void set_pid(uint64_t p_pid);
+
+        inline
+        unsigned int get_index() const;
+
+        inline
+        const std::string & get_name() const;
+
+        /**
+         * @return pid of process that produced log, 0 if log does not mention it
+         */
+        inline
+        uint64_t get_pid() const;
+
+      private:
+
+        unsigned int m_index;
+        std::string m_name;
+
+        /**
+         * Pid can be set by a parsing thread while report is generated
+         */
+        std::atomic<uint64_t> m_pid;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_log_source::valgrind_log_source( unsigned int p_index
+                                            , const std::string & p_name
+                                            )
+    : m_index(p_index)
+    , m_name(p_name)
+    , m_pid(0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_source::set_pid(uint64_t p_pid)
+    {
+        m_pid = p_pid;
+    }
+
+    //-------------------------------------------------------------------------
+    unsigned int
+    valgrind_log_source::get_index() const
+    {
+        return m_index;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::string &
+    valgrind_log_source::get_name() const
+    {
+        return m_name;
+    }
+
+    //-------------------------------------------------------------------------
+    uint64_t
+    valgrind_log_source::get_pid() const
+    {
+        return m_pid;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_SOURCE_H
+// EOF
@@ -0,0 +1,624 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_LOG_STATISTICS_H
+#define VALGRIND_LOG_TOOL_VALGRIND_LOG_STATISTICS_H
+
+#include "valgrind_symbol_statistics.h"
+#include "valgrind_log_content.h"
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <cinttypes>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Occurences of kinds, files, objects, functions, directories and
+     * instruction pointers in the errors of a content, computed in a single
+     * pass over its errors and their stacks. It does not depend on the way
+     * they are reported. With several threads each one aggregates a range
+     * of consecutive errors in its own tables, then ranges are merged in
+     * errors order so that result does not depend on the number of threads
+     */
+    class valgrind_log_statistics
+    {
+      public:
+
+        /**
+         * Aggregate errors of content
+         * @param p_content content to aggregate, it has to outlive
+         * statistics
+         * @param p_jobs number of threads
+         */
+        inline explicit
+        valgrind_log_statistics( const valgrind_log_content & p_content
+                               , unsigned int p_jobs = 1
+                               );
+
+        /**
+         * @return errors per kind, counted once per error
+         */
+        inline
+        const valgrind_symbol_statistics & get_kinds() const;
+
+        /**
+         * @return errors per file, counted once per frame
+         */
+        inline
+        const valgrind_symbol_statistics & get_files() const;
+
+        /**
+         * @return errors per object, counted once per error
+         */
+        inline
+        const valgrind_symbol_statistics & get_objects() const;
+
+        /**
+         * @return errors per function, counted once per error
+         */
+        inline
+        const valgrind_symbol_statistics & get_functions() const;
+
+        /**
+         * @return errors per directory, counted once per error
+         */
+        inline
+        const valgrind_symbol_statistics & get_directories() const;
+
+        /**
+         * @return indexes of first frame met for each instruction pointer
+         * sorted per number of errors mentioning it
+         */
+        inline
+        const std::multimap<unsigned int, uint32_t> & get_sorted_frames() const;
+
+        /**
+         * @param p_frame index of first frame met for an instruction pointer
+         * @return indexes of errors mentioning instruction pointer in
+         * increasing order
+         */
+        inline
+        const std::vector<uint32_t> & get_frame_errors(uint32_t p_frame) const;
+
+        /**
+         * @return indexes of errors sorted per number of occurence
+         */
+        inline
+        const std::multimap<unsigned int, size_t> & get_sorted_errors() const;
+
+        /**
+         * @return number of errors coming from log file
+         */
+        inline
+        unsigned int get_error_number(const valgrind_log_source & p_source) const;
+
+        /**
+         * @param p_error index of error in content error table
+         * @return index of first error whose call stack is identical to the
+         * one of error, error itself if none is before it or if its stack is
+         * empty
+         */
+        inline
+        uint32_t get_stack_error(size_t p_error) const;
+
+        /**
+         * @return number of distinct call stacks
+         */
+        inline
+        size_t get_stack_number() const;
+
+      private:
+
+        /**
+         * Empty statistics to fill with a range of errors
+         */
+        inline
+        valgrind_log_statistics();
+
+        /**
+         * Size tables for symbols, frames and sources of content
+         */
+        inline
+        void reset(const valgrind_log_content & p_content);
+
+        /**
+         * Account errors of a range
+         * @param p_content content owning errors
+         * @param p_begin index of first error
+         * @param p_end index following last error
+         */
+        inline
+        void aggregate( const valgrind_log_content & p_content
+                      , size_t p_begin
+                      , size_t p_end
+                      );
+
+        /**
+         * Add occurences of statistics of the range of errors following
+         * the ones of this statistics
+         * @param p_other statistics to empty
+         * @param p_content content owning errors
+         */
+        inline
+        void take( valgrind_log_statistics & p_other
+                 , const valgrind_log_content & p_content
+                 );
+
+        /**
+         * @return true if two errors have the same call stack
+         */
+        inline static
+        bool is_same_stack( const valgrind_error_table & p_errors
+                          , uint32_t p_first
+                          , uint32_t p_second
+                          );
+
+        /**
+         * Find first error with the same stack as an error among the ones
+         * met by this statistics, error being registered if none. An error
+         * without stack is always registered as its own stack
+         * @param p_errors content error table
+         * @param p_hash hash of error stack
+         * @param p_error index of error
+         * @return index of first error with same stack
+         */
+        inline
+        uint32_t register_stack( const valgrind_error_table & p_errors
+                               , uint64_t p_hash
+                               , uint32_t p_error
+                               );
+
+        /**
+         * Sort symbols, frames and errors once all errors are accounted
+         */
+        inline
+        void rank(const valgrind_log_content & p_content);
+
+        /**
+         * Below this number of stack entries per thread, starting threads
+         * costs more than it saves
+         */
+        static const size_t m_min_entries_per_job = 65536;
+
+        valgrind_symbol_statistics m_kinds;
+
+        valgrind_symbol_statistics m_files;
+
+        valgrind_symbol_statistics m_objects;
+
+        valgrind_symbol_statistics m_functions;
+
+        valgrind_symbol_statistics m_directories;
+
+        /**
+         * Errors mentioning each instruction pointer indexed by index of
+         * first frame met for it
+         */
+        std::vector<std::vector<uint32_t>> m_frame_errors;
+
+        /**
+         * Index of first frame met per instruction pointer
+         */
+        std::map<uint64_t, uint32_t> m_ip_frames;
+
+        std::multimap<unsigned int, uint32_t> m_sorted_frames;
+
+        /**
+         * Error index per source index and unique id to rank error counts
+         */
+        std::map<std::pair<unsigned int, uint64_t>, size_t> m_error_indexes;
+
+        std::multimap<unsigned int, size_t> m_sorted_errors;
+
+        /**
+         * Number of errors indexed by source index
+         */
+        std::vector<unsigned int> m_source_error_numbers;
+
+        /**
+         * Index of first error with the same call stack for each error of
+         * aggregated range
+         */
+        std::vector<uint32_t> m_stack_errors;
+
+        /**
+         * First error of each distinct call stack per stack hash
+         */
+        std::unordered_multimap<uint64_t, uint32_t> m_stack_hashes;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_log_statistics::valgrind_log_statistics()
+    : m_kinds(true)
+    , m_files(false)
+    , m_objects(true)
+    , m_functions(true)
+    , m_directories(true)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_log_statistics::valgrind_log_statistics( const valgrind_log_content & p_content
+                                                    , unsigned int p_jobs
+                                                    )
+    : valgrind_log_statistics()
+    {
+        reset(p_content);
+        const std::vector<size_t> & l_offsets = p_content.get_errors().get_stack_offsets();
+        size_t l_error_number = p_content.get_errors().get_size();
+        size_t l_job_number = std::min(static_cast<size_t>(std::max(1u, p_jobs)), std::max(static_cast<size_t>(1), l_offsets.back() / m_min_entries_per_job));
+        if(1 == l_job_number)
+        {
+            aggregate(p_content, 0, l_error_number);
+            rank(p_content);
+            return;
+        }
+
+        // Ranges are split so that they have about the same number of
+        // stack entries
+        std::vector<size_t> l_bounds{0};
+        for(size_t l_job = 1; l_job < l_job_number; ++l_job)
+        {
+            size_t l_entry = l_offsets.back() / l_job_number * l_job;
+            l_bounds.push_back(std::max(l_bounds.back(), static_cast<size_t>(std::lower_bound(l_offsets.begin(), l_offsets.end(), l_entry) - l_offsets.begin())));
+        }
+        l_bounds.push_back(l_error_number);
+
+        // First range is aggregated directly in this statistics
+        std::vector<std::unique_ptr<valgrind_log_statistics>> l_partials;
+        std::vector<std::exception_ptr> l_exceptions(l_job_number);
+        const auto l_work = [&](size_t p_job)
+        {
+            try
+            {
+                valgrind_log_statistics & l_statistics = p_job ? *l_partials[p_job - 1] : *this;
+                if(p_job)
+                {
+                    l_statistics.reset(p_content);
+                }
+                l_statistics.aggregate(p_content, l_bounds[p_job], l_bounds[p_job + 1]);
+            }
+            catch(...)
+            {
+                l_exceptions[p_job] = std::current_exception();
+            }
+        };
+        for(size_t l_job = 1; l_job < l_job_number; ++l_job)
+        {
+            l_partials.emplace_back(new valgrind_log_statistics());
+        }
+        std::vector<std::thread> l_threads;
+        for(size_t l_job = 1; l_job < l_job_number; ++l_job)
+        {
+            l_threads.emplace_back(l_work, l_job);
+        }
+        l_work(0);
+        for(auto & l_iter: l_threads)
+        {
+            l_iter.join();
+        }
+        for(const auto & l_iter: l_exceptions)
+        {
+            if(l_iter)
+            {
+                std::rethrow_exception(l_iter);
+            }
+        }
+        for(auto & l_iter: l_partials)
+        {
+            take(*l_iter, p_content);
+        }
+        rank(p_content);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_statistics::reset(const valgrind_log_content & p_content)
+    {
+        uint32_t l_symbol_number = p_content.get_symbol_number();
+        m_kinds.reset(l_symbol_number);
+        m_files.reset(l_symbol_number);
+        m_objects.reset(l_symbol_number);
+        m_functions.reset(l_symbol_number);
+        m_directories.reset(l_symbol_number);
+        m_frame_errors.assign(p_content.get_frames().get_size(), std::vector<uint32_t>());
+        m_source_error_numbers.assign(p_content.get_source_number(), 0);
+        m_stack_errors.clear();
+        m_stack_hashes.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_statistics::aggregate( const valgrind_log_content & p_content
+                                      , size_t p_begin
+                                      , size_t p_end
+                                      )
+    {
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        const std::vector<const valgrind_log_source *> & l_sources = l_errors.get_sources();
+        const std::vector<uint64_t> & l_uniques = l_errors.get_uniques();
+        const std::vector<uint32_t> & l_kinds = l_errors.get_kinds();
+        const std::vector<size_t> & l_offsets = l_errors.get_stack_offsets();
+        const std::vector<uint32_t> & l_stack_frames = l_errors.get_stack_frames();
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+
+        // Index of first frame met with same instruction pointer as each
+        // frame, known once frame has been met
+        std::vector<uint32_t> l_first_frames(l_frames.get_size(), UINT32_MAX);
+
+        const auto l_add_symbol = [&](valgrind_symbol_statistics & p_statistics
+                                     , uint32_t p_symbol
+                                     , uint32_t p_error
+                                     )
+        {
+            if(p_symbol)
+            {
+                p_statistics.add(p_symbol, p_error);
+            }
+        };
+
+        for(size_t l_index = p_begin; l_index < p_end; ++l_index)
+        {
+            uint32_t l_error = static_cast<uint32_t>(l_index);
+            unsigned int l_source = l_sources[l_index]->get_index();
+            ++m_source_error_numbers[l_source];
+            m_error_indexes.insert(std::make_pair(std::make_pair(l_source, l_uniques[l_index]), l_index));
+            m_kinds.add(l_kinds[l_index], l_error);
+            // FNV-1a hash of stack frame indexes
+            uint64_t l_hash = 14695981039346656037ULL;
+            for(size_t l_rank = l_offsets[l_index]; l_rank < l_offsets[l_index + 1]; ++l_rank)
+            {
+                uint32_t l_frame_index = l_stack_frames[l_rank];
+                l_hash = (l_hash ^ l_frame_index) * 1099511628211ULL;
+                const valgrind_frame & l_frame = l_frames.get(l_frame_index);
+                l_add_symbol(m_files, l_frame.get_file(), l_error);
+                l_add_symbol(m_objects, l_frame.get_obj(), l_error);
+                l_add_symbol(m_functions, l_frame.get_fn(), l_error);
+                l_add_symbol(m_directories, l_frame.get_dir(), l_error);
+                if(UINT32_MAX == l_first_frames[l_frame_index])
+                {
+                    l_first_frames[l_frame_index] = m_ip_frames.insert(std::make_pair(l_frame.get_ip(), l_frame_index)).first->second;
+                }
+                std::vector<uint32_t> & l_frame_errors = m_frame_errors[l_first_frames[l_frame_index]];
+                if(l_frame_errors.empty() || l_frame_errors.back() != l_error)
+                {
+                    l_frame_errors.push_back(l_error);
+                }
+            }
+            m_stack_errors.push_back(register_stack(l_errors, l_hash, l_error));
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    valgrind_log_statistics::is_same_stack( const valgrind_error_table & p_errors
+                                          , uint32_t p_first
+                                          , uint32_t p_second
+                                          )
+    {
+        const std::vector<size_t> & l_offsets = p_errors.get_stack_offsets();
+        const std::vector<uint32_t> & l_stack_frames = p_errors.get_stack_frames();
+        return l_offsets[p_first + 1] - l_offsets[p_first] == l_offsets[p_second + 1] - l_offsets[p_second]
+            && std::equal(l_stack_frames.begin() + l_offsets[p_first], l_stack_frames.begin() + l_offsets[p_first + 1], l_stack_frames.begin() + l_offsets[p_second]);
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_statistics::register_stack( const valgrind_error_table & p_errors
+                                           , uint64_t p_hash
+                                           , uint32_t p_error
+                                           )
+    {
+        // Errors without stack have nothing in common
+        const std::vector<size_t> & l_offsets = p_errors.get_stack_offsets();
+        if(l_offsets[p_error] == l_offsets[p_error + 1])
+        {
+            m_stack_hashes.insert(std::make_pair(p_hash, p_error));
+            return p_error;
+        }
+        auto l_range = m_stack_hashes.equal_range(p_hash);
+        for(auto l_iter = l_range.first; l_iter != l_range.second; ++l_iter)
+        {
+            if(is_same_stack(p_errors, l_iter->second, p_error))
+            {
+                return l_iter->second;
+            }
+        }
+        m_stack_hashes.insert(std::make_pair(p_hash, p_error));
+        return p_error;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_statistics::take( valgrind_log_statistics & p_other
+                                 , const valgrind_log_content & p_content
+                                 )
+    {
+        m_kinds.take(p_other.m_kinds);
+        m_files.take(p_other.m_files);
+        m_objects.take(p_other.m_objects);
+        m_functions.take(p_other.m_functions);
+        m_directories.take(p_other.m_directories);
+
+        // An instruction pointer already met keeps the first frame met for
+        // it as it comes from previous errors
+        for(const auto & l_iter: p_other.m_ip_frames)
+        {
+            uint32_t l_frame = m_ip_frames.insert(l_iter).first->second;
+            std::vector<uint32_t> & l_errors = m_frame_errors[l_frame];
+            std::vector<uint32_t> & l_other_errors = p_other.m_frame_errors[l_iter.second];
+            if(l_errors.empty())
+            {
+                l_errors.swap(l_other_errors);
+            }
+            else
+            {
+                l_errors.insert(l_errors.end(), l_other_errors.begin(), l_other_errors.end());
+            }
+        }
+        p_other.m_ip_frames.clear();
+        p_other.m_frame_errors.clear();
+
+        for(size_t l_index = 0; l_index < m_source_error_numbers.size(); ++l_index)
+        {
+            m_source_error_numbers[l_index] += p_other.m_source_error_numbers[l_index];
+        }
+        m_error_indexes.insert(p_other.m_error_indexes.begin(), p_other.m_error_indexes.end());
+        p_other.m_error_indexes.clear();
+
+        // Stacks already met keep the first error met with them
+        std::unordered_map<uint32_t, uint32_t> l_stack_errors;
+        for(const auto & l_iter: p_other.m_stack_hashes)
+        {
+            uint32_t l_error = register_stack(p_content.get_errors(), l_iter.first, l_iter.second);
+            if(l_error != l_iter.second)
+            {
+                l_stack_errors.insert(std::make_pair(l_iter.second, l_error));
+            }
+        }
+        for(auto l_error: p_other.m_stack_errors)
+        {
+            auto l_iter = l_stack_errors.find(l_error);
+            m_stack_errors.push_back(l_stack_errors.end() == l_iter ? l_error : l_iter->second);
+        }
+        p_other.m_stack_errors.clear();
+        p_other.m_stack_hashes.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_log_statistics::rank(const valgrind_log_content & p_content)
+    {
+        m_kinds.sort(p_content);
+        m_files.sort(p_content);
+        m_objects.sort(p_content);
+        m_functions.sort(p_content);
+        m_directories.sort(p_content);
+        m_sorted_frames.clear();
+        for(uint32_t l_index = 0; l_index < m_frame_errors.size(); ++l_index)
+        {
+            if(!m_frame_errors[l_index].empty())
+            {
+                m_sorted_frames.insert(std::make_pair(m_frame_errors[l_index].size(), l_index));
+            }
+        }
+        m_sorted_errors.clear();
+        const auto l_rank_error = [&]( const valgrind_log_source & p_source
+                                     , uint64_t p_unique
+                                     , uint32_t p_count
+                                     )
+        {
+            auto l_iter = m_error_indexes.find(std::make_pair(p_source.get_index(), p_unique));
+            if(m_error_indexes.end() != l_iter)
+            {
+                m_sorted_errors.insert(std::make_pair(p_count, l_iter->second));
+            }
+        };
+        p_content.process_error_counts(l_rank_error);
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_symbol_statistics &
+    valgrind_log_statistics::get_kinds() const
+    {
+        return m_kinds;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_symbol_statistics &
+    valgrind_log_statistics::get_files() const
+    {
+        return m_files;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_symbol_statistics &
+    valgrind_log_statistics::get_objects() const
+    {
+        return m_objects;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_symbol_statistics &
+    valgrind_log_statistics::get_functions() const
+    {
+        return m_functions;
+    }
+
+    //-------------------------------------------------------------------------
+    const valgrind_symbol_statistics &
+    valgrind_log_statistics::get_directories() const
+    {
+        return m_directories;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::multimap<unsigned int, uint32_t> &
+    valgrind_log_statistics::get_sorted_frames() const
+    {
+        return m_sorted_frames;
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint32_t> &
+    valgrind_log_statistics::get_frame_errors(uint32_t p_frame) const
+    {
+        assert(p_frame < m_frame_errors.size());
+        return m_frame_errors[p_frame];
+    }
+
+    //-------------------------------------------------------------------------
+    const std::multimap<unsigned int, size_t> &
+    valgrind_log_statistics::get_sorted_errors() const
+    {
+        return m_sorted_errors;
+    }
+
+    //-------------------------------------------------------------------------
+    unsigned int
+    valgrind_log_statistics::get_error_number(const valgrind_log_source & p_source) const
+    {
+        assert(p_source.get_index() < m_source_error_numbers.size());
+        return m_source_error_numbers[p_source.get_index()];
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_log_statistics::get_stack_error(size_t p_error) const
+    {
+        assert(p_error < m_stack_errors.size());
+        return m_stack_errors[p_error];
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    valgrind_log_statistics::get_stack_number() const
+    {
+        return m_stack_hashes.size();
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_LOG_STATISTICS_H
+// EOF
@@ -0,0 +1,241 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_STATISTICS_H
+#define VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_STATISTICS_H
+
+#include "valgrind_log_content.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cinttypes>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Occurences of the symbols met in one field of errors, for example
+     * their kind or the function of their frames. Symbols are numbered in
+     * order of first appearance
+     */
+    class valgrind_symbol_statistics
+    {
+      public:
+
+        /**
+         * @param p_once_per_error true to count errors mentioning symbols
+         * instead of mentions
+         */
+        inline explicit
+        valgrind_symbol_statistics(bool p_once_per_error);
+
+        /**
+         * Forget previous occurences
+         * @param p_symbol_number number of symbols of content
+         */
+        inline
+        void reset(uint32_t p_symbol_number);
+
+        /**
+         * Account a mention of symbol in an error. Errors have to be
+         * given in increasing order
+         * @param p_symbol symbol id
+         * @param p_error error index in content error table
+         */
+        inline
+        void add( uint32_t p_symbol
+                , uint32_t p_error
+                );
+
+        /**
+         * Rank met symbols per number of occurence, symbols with the same
+         * number of occurences being sorted by name
+         * @param p_content content owning symbols
+         */
+        inline
+        void sort(const valgrind_log_content & p_content);
+
+        /**
+         * Add occurences of another statistics of the same field, whose
+         * errors all come after the ones of this statistics
+         * @param p_other statistics to empty
+         */
+        inline
+        void take(valgrind_symbol_statistics & p_other);
+
+        /**
+         * @return number of symbol in order of first appearance
+         */
+        inline
+        unsigned int get_number(uint32_t p_symbol) const;
+
+        /**
+         * @return indexes of errors mentioning symbol in increasing order
+         */
+        inline
+        const std::vector<uint32_t> & get_errors(uint32_t p_symbol) const;
+
+        /**
+         * @return met symbols sorted per number of occurence
+         */
+        inline
+        const std::multimap<unsigned int, uint32_t> & get_sorted() const;
+
+      private:
+
+        bool m_once_per_error;
+
+        /**
+         * Number of each symbol indexed by symbol id
+         */
+        std::vector<unsigned int> m_numbers;
+
+        /**
+         * Number of occurences indexed by symbol id
+         */
+        std::vector<unsigned int> m_counts;
+
+        /**
+         * Errors mentioning each symbol indexed by symbol id
+         */
+        std::vector<std::vector<uint32_t>> m_errors;
+
+        /**
+         * Symbols in order of first appearance
+         */
+        std::vector<uint32_t> m_met_symbols;
+
+        std::multimap<unsigned int, uint32_t> m_sorted;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_symbol_statistics::valgrind_symbol_statistics(bool p_once_per_error)
+    : m_once_per_error(p_once_per_error)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_symbol_statistics::reset(uint32_t p_symbol_number)
+    {
+        m_numbers.assign(p_symbol_number, 0);
+        m_counts.assign(p_symbol_number, 0);
+        m_errors.assign(p_symbol_number, std::vector<uint32_t>());
+        m_met_symbols.clear();
+        m_sorted.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_symbol_statistics::add( uint32_t p_symbol
+                                   , uint32_t p_error
+                                   )
+    {
+        assert(p_symbol < m_counts.size());
+        // Errors come in order so last one listed tells if symbol has
+        // already been met in this error
+        std::vector<uint32_t> & l_errors = m_errors[p_symbol];
+        bool l_new_error = l_errors.empty() || l_errors.back() != p_error;
+        if(m_once_per_error && !l_new_error)
+        {
+            return;
+        }
+        if(!m_counts[p_symbol])
+        {
+            m_numbers[p_symbol] = static_cast<unsigned int>(m_met_symbols.size());
+            m_met_symbols.push_back(p_symbol);
+        }
+        ++m_counts[p_symbol];
+        if(l_new_error)
+        {
+            l_errors.push_back(p_error);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_symbol_statistics::sort(const valgrind_log_content & p_content)
+    {
+        std::vector<uint32_t> l_symbols(m_met_symbols);
+        const auto l_compare_names = [&](uint32_t p_first, uint32_t p_second)
+        {
+            return p_content.get_symbol(p_first) < p_content.get_symbol(p_second);
+        };
+        std::sort(l_symbols.begin(), l_symbols.end(), l_compare_names);
+        m_sorted.clear();
+        for(auto l_symbol: l_symbols)
+        {
+            m_sorted.insert(std::make_pair(m_counts[l_symbol], l_symbol));
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    valgrind_symbol_statistics::take(valgrind_symbol_statistics & p_other)
+    {
+        assert(m_counts.size() == p_other.m_counts.size());
+        // Symbols new to this statistics keep their order of appearance
+        for(auto l_symbol: p_other.m_met_symbols)
+        {
+            if(!m_counts[l_symbol])
+            {
+                m_numbers[l_symbol] = static_cast<unsigned int>(m_met_symbols.size());
+                m_met_symbols.push_back(l_symbol);
+            }
+            m_counts[l_symbol] += p_other.m_counts[l_symbol];
+            std::vector<uint32_t> & l_errors = m_errors[l_symbol];
+            std::vector<uint32_t> & l_other_errors = p_other.m_errors[l_symbol];
+            if(l_errors.empty())
+            {
+                l_errors.swap(l_other_errors);
+            }
+            else
+            {
+                l_errors.insert(l_errors.end(), l_other_errors.begin(), l_other_errors.end());
+            }
+        }
+        p_other.reset(0);
+    }
+
+    //-------------------------------------------------------------------------
+    unsigned int
+    valgrind_symbol_statistics::get_number(uint32_t p_symbol) const
+    {
+        assert(p_symbol < m_numbers.size());
+        return m_numbers[p_symbol];
+    }
+
+    //-------------------------------------------------------------------------
+    const std::vector<uint32_t> &
+    valgrind_symbol_statistics::get_errors(uint32_t p_symbol) const
+    {
+        assert(p_symbol < m_errors.size());
+        return m_errors[p_symbol];
+    }
+
+    //-------------------------------------------------------------------------
+    const std::multimap<unsigned int, uint32_t> &
+    valgrind_symbol_statistics::get_sorted() const
+    {
+        return m_sorted;
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_STATISTICS_H
+// EOF
@@ -0,0 +1,177 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_TABLE_H
+#define VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_TABLE_H
+
+#include "string_ref.h"
+#include "string_storage.h"
+#include <vector>
+#include <unordered_map>
+#include <cinttypes>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Pool of strings naming objects, functions, directories and files of
+     * frames. Each distinct string is stored once and designated by an id,
+     * id 0 being the empty string
+     */
+    class valgrind_symbol_table
+    {
+      public:
+
+        inline
+        valgrind_symbol_table();
+
+        valgrind_symbol_table(const valgrind_symbol_table &) = delete;
+
+        valgrind_symbol_table & operator=(const valgrind_symbol_table &) = delete;
+
+        /**
+         * Find id of string, store it if not yet known
+         * @param p_string string read from log
+         * @param p_persistent true if string lives as long as table so it
+         * does not need to be copied
+         * @return id of string
+         */
+        inline
+        uint32_t add( const string_ref & p_string
+                    , bool p_persistent
+                    );
+
+        inline
+        const string_ref & get(uint32_t p_id) const;
+
+        inline
+        uint32_t get_size() const;
+
+        /**
+         * Move strings of another table in this one
+         * @param p_other table to empty
+         * @return new id of each string of other table, empty if ids did not
+         * change
+         */
+        inline
+        std::vector<uint32_t> take(valgrind_symbol_table & p_other);
+
+      private:
+
+        /**
+         * FNV-1a hash of string characters
+         */
+        struct hash
+        {
+            inline
+            size_t operator()(const string_ref & p_string) const;
+        };
+
+        std::vector<string_ref> m_strings;
+
+        std::unordered_map<string_ref, uint32_t, hash> m_ids;
+
+        /**
+         * Copies of strings that are not persistent
+         */
+        string_storage m_storage;
+    };
+
+    //-------------------------------------------------------------------------
+    valgrind_symbol_table::valgrind_symbol_table()
+    : m_strings(1)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_symbol_table::add( const string_ref & p_string
+                              , bool p_persistent
+                              )
+    {
+        if(p_string.empty())
+        {
+            return 0;
+        }
+        auto l_iter = m_ids.find(p_string);
+        if(m_ids.end() != l_iter)
+        {
+            return l_iter->second;
+        }
+        uint32_t l_id = static_cast<uint32_t>(m_strings.size());
+        m_strings.push_back(p_persistent ? p_string : m_storage.store(p_string));
+        m_ids.insert(std::make_pair(m_strings.back(), l_id));
+        return l_id;
+    }
+
+    //-------------------------------------------------------------------------
+    const string_ref &
+    valgrind_symbol_table::get(uint32_t p_id) const
+    {
+        assert(p_id < m_strings.size());
+        return m_strings[p_id];
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    valgrind_symbol_table::get_size() const
+    {
+        return static_cast<uint32_t>(m_strings.size());
+    }
+
+    //-------------------------------------------------------------------------
+    std::vector<uint32_t>
+    valgrind_symbol_table::take(valgrind_symbol_table & p_other)
+    {
+        std::vector<uint32_t> l_ids;
+        if(1 == m_strings.size())
+        {
+            m_strings.swap(p_other.m_strings);
+            m_ids.swap(p_other.m_ids);
+        }
+        else
+        {
+            // Strings of other table are moved with its storage
+            l_ids.reserve(p_other.m_strings.size());
+            for(const auto & l_iter: p_other.m_strings)
+            {
+                l_ids.push_back(add(l_iter, true));
+            }
+            p_other.m_strings.resize(1);
+            p_other.m_ids.clear();
+        }
+        m_storage.take(p_other.m_storage);
+        return l_ids;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    valgrind_symbol_table::hash::operator()(const string_ref & p_string) const
+    {
+        uint64_t l_hash = 14695981039346656037ULL;
+        for(size_t l_index = 0; l_index < p_string.size(); ++l_index)
+        {
+            l_hash ^= static_cast<unsigned char>(p_string.data()[l_index]);
+            l_hash *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(l_hash);
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_SYMBOL_TABLE_H
+// EOF
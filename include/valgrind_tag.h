@@ -0,0 +1,446 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VALGRIND_TAG_H
+#define VALGRIND_LOG_TOOL_VALGRIND_TAG_H
+
+#include "string_ref.h"
+#include <cstring>
+#include <cstdint>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Nodes of valgrind XML protocol
+     */
+    enum class valgrind_tag: unsigned char
+    { valgrindoutput
+    , protocolversion
+    , protocoltool
+    , preamble
+    , pid
+    , ppid
+    , tool
+    , args
+    , status
+    , error
+    , unique
+    , tid
+    , kind
+    , what
+    , auxwhat
+    , stack
+    , frame
+    , ip
+    , obj
+    , fn
+    , dir
+    , file
+    , line
+    , xwhat
+    , text
+    , leakedbytes
+    , leakedblocks
+    , pair
+    , count
+    , errorcounts
+    , suppcounts
+    , unknown
+    };
+
+    /**
+     * Number of known tags
+     */
+    static const unsigned int valgrind_tag_number = static_cast<unsigned int>(valgrind_tag::unknown);
+    static_assert(valgrind_tag_number <= 32, "Tag sets are stored in 32 bits");
+
+    /**
+     * @param p_tag tag
+     * @return bit representing tag in a set of tags
+     */
+    inline
+    uint32_t get_valgrind_tag_mask(valgrind_tag p_tag);
+
+    /**
+     * Identify tag from its name without building any string: candidates are
+     * selected by switches on name size and first character then compared
+     * @param p_name tag name
+     * @return tag or valgrind_tag::unknown
+     */
+    inline
+    valgrind_tag get_valgrind_tag(const string_ref & p_name);
+
+    /**
+     * @param p_tag tag
+     * @return name of tag in valgrind XML protocol
+     */
+    inline
+    const char * get_valgrind_tag_name(valgrind_tag p_tag);
+
+    /**
+     * Check that name matches a tag whose size is already known to be the
+     * same as name size
+     */
+    template <size_t SIZE>
+    inline
+    bool is_tag( const string_ref & p_name
+               , const char (& p_tag)[SIZE]
+               );
+
+    //-------------------------------------------------------------------------
+    template <size_t SIZE>
+    bool is_tag( const string_ref & p_name
+               , const char (& p_tag)[SIZE]
+               )
+    {
+        return !memcmp(p_name.data(), p_tag, SIZE - 1);
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t get_valgrind_tag_mask(valgrind_tag p_tag)
+    {
+        return static_cast<uint32_t>(1) << static_cast<unsigned int>(p_tag);
+    }
+
+    //-------------------------------------------------------------------------
+    valgrind_tag get_valgrind_tag(const string_ref & p_name)
+    {
+        switch(p_name.size())
+        {
+            case 2:
+                switch(p_name.data()[0])
+                {
+                    case 'f':
+                        if(is_tag(p_name, "fn"))
+                        {
+                            return valgrind_tag::fn;
+                        }
+                        break;
+                    case 'i':
+                        if(is_tag(p_name, "ip"))
+                        {
+                            return valgrind_tag::ip;
+                        }
+                        break;
+                }
+                break;
+            case 3:
+                switch(p_name.data()[0])
+                {
+                    case 'd':
+                        if(is_tag(p_name, "dir"))
+                        {
+                            return valgrind_tag::dir;
+                        }
+                        break;
+                    case 'o':
+                        if(is_tag(p_name, "obj"))
+                        {
+                            return valgrind_tag::obj;
+                        }
+                        break;
+                    case 'p':
+                        if(is_tag(p_name, "pid"))
+                        {
+                            return valgrind_tag::pid;
+                        }
+                        break;
+                    case 't':
+                        if(is_tag(p_name, "tid"))
+                        {
+                            return valgrind_tag::tid;
+                        }
+                        break;
+                }
+                break;
+            case 4:
+                switch(p_name.data()[0])
+                {
+                    case 'a':
+                        if(is_tag(p_name, "args"))
+                        {
+                            return valgrind_tag::args;
+                        }
+                        break;
+                    case 'f':
+                        if(is_tag(p_name, "file"))
+                        {
+                            return valgrind_tag::file;
+                        }
+                        break;
+                    case 'k':
+                        if(is_tag(p_name, "kind"))
+                        {
+                            return valgrind_tag::kind;
+                        }
+                        break;
+                    case 'l':
+                        if(is_tag(p_name, "line"))
+                        {
+                            return valgrind_tag::line;
+                        }
+                        break;
+                    case 'p':
+                        if(is_tag(p_name, "ppid"))
+                        {
+                            return valgrind_tag::ppid;
+                        }
+                        if(is_tag(p_name, "pair"))
+                        {
+                            return valgrind_tag::pair;
+                        }
+                        break;
+                    case 't':
+                        if(is_tag(p_name, "tool"))
+                        {
+                            return valgrind_tag::tool;
+                        }
+                        if(is_tag(p_name, "text"))
+                        {
+                            return valgrind_tag::text;
+                        }
+                        break;
+                    case 'w':
+                        if(is_tag(p_name, "what"))
+                        {
+                            return valgrind_tag::what;
+                        }
+                        break;
+                }
+                break;
+            case 5:
+                switch(p_name.data()[0])
+                {
+                    case 'c':
+                        if(is_tag(p_name, "count"))
+                        {
+                            return valgrind_tag::count;
+                        }
+                        break;
+                    case 'e':
+                        if(is_tag(p_name, "error"))
+                        {
+                            return valgrind_tag::error;
+                        }
+                        break;
+                    case 'f':
+                        if(is_tag(p_name, "frame"))
+                        {
+                            return valgrind_tag::frame;
+                        }
+                        break;
+                    case 's':
+                        if(is_tag(p_name, "stack"))
+                        {
+                            return valgrind_tag::stack;
+                        }
+                        break;
+                    case 'x':
+                        if(is_tag(p_name, "xwhat"))
+                        {
+                            return valgrind_tag::xwhat;
+                        }
+                        break;
+                }
+                break;
+            case 6:
+                switch(p_name.data()[0])
+                {
+                    case 's':
+                        if(is_tag(p_name, "status"))
+                        {
+                            return valgrind_tag::status;
+                        }
+                        break;
+                    case 'u':
+                        if(is_tag(p_name, "unique"))
+                        {
+                            return valgrind_tag::unique;
+                        }
+                        break;
+                }
+                break;
+            case 7:
+                switch(p_name.data()[0])
+                {
+                    case 'a':
+                        if(is_tag(p_name, "auxwhat"))
+                        {
+                            return valgrind_tag::auxwhat;
+                        }
+                        break;
+                }
+                break;
+            case 8:
+                switch(p_name.data()[0])
+                {
+                    case 'p':
+                        if(is_tag(p_name, "preamble"))
+                        {
+                            return valgrind_tag::preamble;
+                        }
+                        break;
+                }
+                break;
+            case 10:
+                switch(p_name.data()[0])
+                {
+                    case 's':
+                        if(is_tag(p_name, "suppcounts"))
+                        {
+                            return valgrind_tag::suppcounts;
+                        }
+                        break;
+                }
+                break;
+            case 11:
+                switch(p_name.data()[0])
+                {
+                    case 'e':
+                        if(is_tag(p_name, "errorcounts"))
+                        {
+                            return valgrind_tag::errorcounts;
+                        }
+                        break;
+                    case 'l':
+                        if(is_tag(p_name, "leakedbytes"))
+                        {
+                            return valgrind_tag::leakedbytes;
+                        }
+                        break;
+                }
+                break;
+            case 12:
+                switch(p_name.data()[0])
+                {
+                    case 'l':
+                        if(is_tag(p_name, "leakedblocks"))
+                        {
+                            return valgrind_tag::leakedblocks;
+                        }
+                        break;
+                    case 'p':
+                        if(is_tag(p_name, "protocoltool"))
+                        {
+                            return valgrind_tag::protocoltool;
+                        }
+                        break;
+                }
+                break;
+            case 14:
+                switch(p_name.data()[0])
+                {
+                    case 'v':
+                        if(is_tag(p_name, "valgrindoutput"))
+                        {
+                            return valgrind_tag::valgrindoutput;
+                        }
+                        break;
+                }
+                break;
+            case 15:
+                switch(p_name.data()[0])
+                {
+                    case 'p':
+                        if(is_tag(p_name, "protocolversion"))
+                        {
+                            return valgrind_tag::protocolversion;
+                        }
+                        break;
+                }
+                break;
+        }
+        return valgrind_tag::unknown;
+    }
+
+    //-------------------------------------------------------------------------
+    const char * get_valgrind_tag_name(valgrind_tag p_tag)
+    {
+        switch(p_tag)
+        {
+            case valgrind_tag::valgrindoutput:
+                return "valgrindoutput";
+            case valgrind_tag::protocolversion:
+                return "protocolversion";
+            case valgrind_tag::protocoltool:
+                return "protocoltool";
+            case valgrind_tag::preamble:
+                return "preamble";
+            case valgrind_tag::pid:
+                return "pid";
+            case valgrind_tag::ppid:
+                return "ppid";
+            case valgrind_tag::tool:
+                return "tool";
+            case valgrind_tag::args:
+                return "args";
+            case valgrind_tag::status:
+                return "status";
+            case valgrind_tag::error:
+                return "error";
+            case valgrind_tag::unique:
+                return "unique";
+            case valgrind_tag::tid:
+                return "tid";
+            case valgrind_tag::kind:
+                return "kind";
+            case valgrind_tag::what:
+                return "what";
+            case valgrind_tag::auxwhat:
+                return "auxwhat";
+            case valgrind_tag::stack:
+                return "stack";
+            case valgrind_tag::frame:
+                return "frame";
+            case valgrind_tag::ip:
+                return "ip";
+            case valgrind_tag::obj:
+                return "obj";
+            case valgrind_tag::fn:
+                return "fn";
+            case valgrind_tag::dir:
+                return "dir";
+            case valgrind_tag::file:
+                return "file";
+            case valgrind_tag::line:
+                return "line";
+            case valgrind_tag::xwhat:
+                return "xwhat";
+            case valgrind_tag::text:
+                return "text";
+            case valgrind_tag::leakedbytes:
+                return "leakedbytes";
+            case valgrind_tag::leakedblocks:
+                return "leakedblocks";
+            case valgrind_tag::pair:
+                return "pair";
+            case valgrind_tag::count:
+                return "count";
+            case valgrind_tag::errorcounts:
+                return "errorcounts";
+            case valgrind_tag::suppcounts:
+                return "suppcounts";
+            case valgrind_tag::unknown:
+                break;
+        }
+        return "unknown";
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VALGRIND_TAG_H
+// EOF
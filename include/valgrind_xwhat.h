@@ -19,7 +19,7 @@
 #ifndef VALGRIND_LOG_TOOL_VALGRIND_XWHAT_H
 #define VALGRIND_LOG_TOOL_VALGRIND_XWHAT_H
 
-#include <string>
+#include "string_ref.h"
 
 namespace valgrind_log_tool
 {
@@ -31,27 +31,27 @@ namespace valgrind_log_tool
         valgrind_xwhat();
 
         inline
-        void set_text(std::string && p_text);
+        void set_text(const string_ref & p_text);
 
         inline
-        void set_leaked_bytes(uint32_t p_leaked_bytes);
+        void set_leaked_bytes(uint64_t p_leaked_bytes);
 
         inline
-        void set_leaked_blocks(uint32_t p_leaked_bytes);
+        void set_leaked_blocks(uint64_t p_leaked_bytes);
 
         inline
-        const std::string & get_text() const;
+        const string_ref & get_text() const;
 
         inline
-        uint32_t get_leaked_bytes() const;
+        uint64_t get_leaked_bytes() const;
 
         inline
-        uint32_t get_leaked_blocks() const;
+        uint64_t get_leaked_blocks() const;
 
       private:
-        std::string m_text;
-        uint32_t m_leaked_bytes;
-        uint32_t m_leaked_blocks;
+        string_ref m_text;
+        uint64_t m_leaked_bytes;
+        uint64_t m_leaked_blocks;
     };
 
     //-------------------------------------------------------------------------
@@ -63,41 +63,41 @@ namespace valgrind_log_tool
     }
 
     //-------------------------------------------------------------------------
-    void valgrind_xwhat::set_text(std::string && p_text)
+    void valgrind_xwhat::set_text(const string_ref & p_text)
     {
         m_text = p_text;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_xwhat::set_leaked_bytes(uint32_t p_leaked_bytes)
+    valgrind_xwhat::set_leaked_bytes(uint64_t p_leaked_bytes)
     {
         m_leaked_bytes = p_leaked_bytes;
     }
 
     //-------------------------------------------------------------------------
     void
-    valgrind_xwhat::set_leaked_blocks(uint32_t p_leaked_bytes)
+    valgrind_xwhat::set_leaked_blocks(uint64_t p_leaked_bytes)
     {
         m_leaked_blocks = p_leaked_bytes;
     }
 
     //-------------------------------------------------------------------------
-    const std::string &
+    const string_ref &
     valgrind_xwhat::get_text() const
     {
         return m_text;
     }
 
     //-------------------------------------------------------------------------
-    uint32_t
+    uint64_t
     valgrind_xwhat::get_leaked_bytes() const
     {
         return m_leaked_bytes;
     }
 
     //-------------------------------------------------------------------------
-    uint32_t
+    uint64_t
     valgrind_xwhat::get_leaked_blocks() const
     {
         return m_leaked_blocks;
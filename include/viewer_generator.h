@@ -0,0 +1,667 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_VIEWER_GENERATOR_H
+#define VALGRIND_LOG_TOOL_VIEWER_GENERATOR_H
+
+#include "valgrind_log_statistics.h"
+#include "valgrind_log_content.h"
+#include "report_generator.h"
+#include "report_file.h"
+#include "json_generator.h"
+#include "quicky_exception.h"
+#include <ostream>
+#include <ios>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cinttypes>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Write report as a single self contained page: content tables are
+     * written once as JSON data and a small script renders lists and
+     * tables on demand, only drawing rows that are visible. Page does not
+     * load anything else so it can be opened offline from a local file
+     */
+    class viewer_generator: public report_generator
+    {
+      public:
+
+        /**
+         * @param p_output_file_name name of report file
+         * @param p_jobs number of threads compressing report
+         * @param p_compressed true to write report compressed with gzip
+         */
+        inline explicit
+        viewer_generator( const std::string & p_output_file_name
+                        , unsigned int p_jobs = 1
+                        , bool p_compressed = false
+                        );
+
+        /**
+         * Write report
+         * @param p_content content to report
+         * @param p_statistics statistics of content
+         */
+        inline
+        void generate( const valgrind_log_content & p_content
+                     , const valgrind_log_statistics & p_statistics
+                     ) override;
+
+      private:
+
+        /**
+         * Write data object embedded in page
+         */
+        inline
+        void generate_data( const valgrind_log_content & p_content
+                          , const valgrind_log_statistics & p_statistics
+                          );
+
+        /**
+         * Write a JSON array of numbers
+         */
+        template <typename T>
+        void write_numbers(const std::vector<T> & p_numbers);
+
+        /**
+         * Write sorted entries as a flat JSON array of id and count pairs
+         */
+        template <typename T>
+        void write_sorted(const std::multimap<unsigned int, T> & p_sorted);
+
+        /**
+         * @return id of a string of errors in data string table, strings
+         * being added after symbols the first time they are met
+         */
+        inline
+        uint32_t get_string_id(const string_ref & p_string);
+
+        /**
+         * @return document head and elements filled by script
+         */
+        inline static
+        const char * get_page_start();
+
+        /**
+         * @return script rendering data
+         */
+        inline static
+        const char * get_script();
+
+        report_file m_file;
+
+        /**
+         * Strings of data string table following symbols
+         */
+        std::vector<string_ref> m_strings;
+
+        std::unordered_map<std::string, uint32_t> m_string_ids;
+
+        /**
+         * Number of symbols of content, first id of other strings
+         */
+        uint32_t m_symbol_number;
+    };
+
+    //-------------------------------------------------------------------------
+    viewer_generator::viewer_generator( const std::string & p_output_file_name
+                                      , unsigned int p_jobs
+                                      , bool p_compressed
+                                      )
+    : m_file(p_output_file_name, p_compressed, p_jobs)
+    , m_symbol_number(0)
+    {
+
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    viewer_generator::generate( const valgrind_log_content & p_content
+                              , const valgrind_log_statistics & p_statistics
+                              )
+    {
+        m_file << get_page_start();
+        m_file << R"(<script id="data" type="application/json">)";
+        generate_data(p_content, p_statistics);
+        m_file << "</script>\n";
+        m_file << "<script>\n" << get_script() << "</script>\n";
+        m_file << "</body>\n" << "</html>\n";
+
+        m_file.close();
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    viewer_generator::generate_data( const valgrind_log_content & p_content
+                                   , const valgrind_log_statistics & p_statistics
+                                   )
+    {
+        m_symbol_number = p_content.get_symbol_number();
+        m_strings.clear();
+        m_string_ids.clear();
+
+        // Strings of errors are numbered first so that string table is
+        // complete when written
+        const valgrind_error_table & l_errors = p_content.get_errors();
+        std::vector<uint32_t> l_whats;
+        std::vector<uint32_t> l_aux_whats;
+        std::vector<int64_t> l_xwhats;
+        l_whats.reserve(l_errors.get_size());
+        l_aux_whats.reserve(l_errors.get_size());
+        l_xwhats.reserve(l_errors.get_size());
+        for(size_t l_index = 0; l_index < l_errors.get_size(); ++l_index)
+        {
+            l_whats.push_back(get_string_id(l_errors.get_whats()[l_index]));
+            l_aux_whats.push_back(get_string_id(l_errors.get_aux_whats()[l_index]));
+            l_xwhats.push_back(l_errors.get_has_xwhats()[l_index] ? static_cast<int64_t>(get_string_id(l_errors.get_xwhat_texts()[l_index])) : -1);
+        }
+
+        m_file << R"({"strings":[)";
+        for(uint32_t l_id = 0; l_id < m_symbol_number; ++l_id)
+        {
+            if(l_id)
+            {
+                m_file << ',';
+            }
+            json_generator::write_string(m_file, p_content.get_symbol(l_id));
+        }
+        for(const auto & l_iter: m_strings)
+        {
+            m_file << ',';
+            json_generator::write_string(m_file, l_iter);
+        }
+        m_file << "],\n";
+
+        m_file << R"("sources":[)";
+        bool l_first = true;
+        const auto l_write_source = [&](const valgrind_log_source & p_source)
+        {
+            if(!l_first)
+            {
+                m_file << ',';
+            }
+            l_first = false;
+            m_file << '[';
+            json_generator::write_string(m_file, p_source.get_name());
+            m_file << ',' << p_source.get_pid() << ',' << p_statistics.get_error_number(p_source) << ']';
+        };
+        p_content.process_sources(l_write_source);
+        m_file << "],\n";
+
+        // Frames are flattened as ip, object, function, directory, file and
+        // line. Ips are hexadecimal strings as JavaScript numbers cannot hold
+        // addresses above 2^53
+        const valgrind_frame_table & l_frames = p_content.get_frames();
+        m_file << R"("frames":[)";
+        for(uint32_t l_index = 0; l_index < l_frames.get_size(); ++l_index)
+        {
+            const valgrind_frame & l_frame = l_frames.get(l_index);
+            if(l_index)
+            {
+                m_file << ',';
+            }
+            m_file << "\"0x" << std::hex << l_frame.get_ip() << std::dec << "\"," << l_frame.get_obj() << ',' << l_frame.get_fn() << ',' << l_frame.get_dir() << ',' << l_frame.get_file() << ',' << l_frame.get_line();
+        }
+        m_file << "],\n";
+
+        std::vector<unsigned int> l_sources;
+        l_sources.reserve(l_errors.get_size());
+        for(auto l_source: l_errors.get_sources())
+        {
+            l_sources.push_back(l_source->get_index());
+        }
+        m_file << R"("errors":{"source":)";
+        write_numbers(l_sources);
+        m_file << R"(,"unique":)";
+        write_numbers(l_errors.get_uniques());
+        m_file << R"(,"tid":)";
+        write_numbers(l_errors.get_tids());
+        m_file << R"(,"kind":)";
+        write_numbers(l_errors.get_kinds());
+        m_file << R"(,"what":)";
+        write_numbers(l_whats);
+        m_file << R"(,"auxWhat":)";
+        write_numbers(l_aux_whats);
+        m_file << R"(,"xwhat":)";
+        write_numbers(l_xwhats);
+        m_file << R"(,"leakedBytes":)";
+        write_numbers(l_errors.get_leaked_bytes());
+        m_file << R"(,"leakedBlocks":)";
+        write_numbers(l_errors.get_leaked_blocks());
+        m_file << R"(,"stackOffsets":)";
+        write_numbers(l_errors.get_stack_offsets());
+        m_file << R"(,"stackFrames":)";
+        write_numbers(l_errors.get_stack_frames());
+        m_file << "},\n";
+
+        m_file << R"("sorted":{"kinds":)";
+        write_sorted(p_statistics.get_kinds().get_sorted());
+        m_file << R"(,"files":)";
+        write_sorted(p_statistics.get_files().get_sorted());
+        m_file << R"(,"objects":)";
+        write_sorted(p_statistics.get_objects().get_sorted());
+        m_file << R"(,"functions":)";
+        write_sorted(p_statistics.get_functions().get_sorted());
+        m_file << R"(,"directories":)";
+        write_sorted(p_statistics.get_directories().get_sorted());
+        m_file << R"(,"frames":)";
+        write_sorted(p_statistics.get_sorted_frames());
+        m_file << R"(,"errors":)";
+        write_sorted(p_statistics.get_sorted_errors());
+        m_file << "}}";
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t
+    viewer_generator::get_string_id(const string_ref & p_string)
+    {
+        auto l_iter = m_string_ids.insert(std::make_pair(std::string(p_string.data(), p_string.size()), m_symbol_number + static_cast<uint32_t>(m_strings.size())));
+        if(l_iter.second)
+        {
+            m_strings.push_back(p_string);
+        }
+        return l_iter.first->second;
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    void
+    viewer_generator::write_numbers(const std::vector<T> & p_numbers)
+    {
+        m_file << '[';
+        for(size_t l_index = 0; l_index < p_numbers.size(); ++l_index)
+        {
+            if(l_index)
+            {
+                m_file << ',';
+            }
+            m_file << p_numbers[l_index];
+        }
+        m_file << ']';
+    }
+
+    //-------------------------------------------------------------------------
+    template <typename T>
+    void
+    viewer_generator::write_sorted(const std::multimap<unsigned int, T> & p_sorted)
+    {
+        m_file << '[';
+        bool l_first = true;
+        for(const auto & l_iter: p_sorted)
+        {
+            if(!l_first)
+            {
+                m_file << ',';
+            }
+            l_first = false;
+            m_file << l_iter.second << ',' << l_iter.first;
+        }
+        m_file << ']';
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    viewer_generator::get_page_start()
+    {
+        return R"viewer(<!DOCTYPE html>
+<html>
+<head>
+<meta http-equiv="Content-Type" content="text/html; charset=utf-8">
+<title>Valgrind_report</title>
+<style>
+body { font-family: sans-serif; margin: 0 1em; }
+#tabs button { margin: 0 0.2em 0.5em 0; }
+#tabs button.selected { font-weight: bold; }
+#panes { display: flex; gap: 1em; }
+#list { flex: 1; height: 80vh; overflow-y: auto; border: 1px solid #888; position: relative; }
+#spacer { position: relative; }
+#detail { flex: 1; height: 80vh; overflow: auto; }
+.row { position: absolute; left: 0; right: 0; height: 22px; line-height: 22px; white-space: nowrap; overflow: hidden; padding: 0 0.3em; }
+.row:nth-child(even) { background: #f0f0f0; }
+.row span { margin-right: 0.8em; }
+.link { color: #00e; cursor: pointer; text-decoration: underline; }
+table { border-collapse: collapse; }
+td, th { border: 1px solid #888; padding: 0 0.3em; }
+</style>
+</head>
+<body>
+<H1>Valgrind_report</H1>
+<div id="tabs"></div>
+<H2 id="heading"></H2>
+<div id="panes">
+<div id="list"><div id="spacer"></div></div>
+<div id="detail"></div>
+</div>
+)viewer";
+    }
+
+    //-------------------------------------------------------------------------
+    const char *
+    viewer_generator::get_script()
+    {
+        return R"viewer((function()
+{
+    'use strict';
+    var data = JSON.parse(document.getElementById('data').textContent);
+    var strings = data.strings;
+    var frames = data.frames;
+    var errors = data.errors;
+    var errorNumber = errors.unique.length;
+    var multipleSources = data.sources.length > 1;
+    var rowHeight = 22;
+
+    function element(parent, tag, text, action)
+    {
+        var node = document.createElement(tag);
+        if(undefined !== text)
+        {
+            node.textContent = text;
+        }
+        if(action)
+        {
+            node.className = 'link';
+            node.onclick = action;
+        }
+        parent.appendChild(node);
+        return node;
+    }
+
+    function errorName(index)
+    {
+        var unique = errors.unique[index];
+        return multipleSources ? data.sources[errors.source[index]][1] + ':' + unique : String(unique);
+    }
+
+    // Only rows in view are in document, they are redrawn on scroll
+    var list = document.getElementById('list');
+    var spacer = document.getElementById('spacer');
+    var heading = document.getElementById('heading');
+    var detail = document.getElementById('detail');
+    var rowNumber = 0;
+    var renderRow = null;
+    var drawPending = false;
+
+    function draw()
+    {
+        drawPending = false;
+        var first = Math.floor(list.scrollTop / rowHeight);
+        var last = Math.min(rowNumber, first + Math.ceil(list.clientHeight / rowHeight) + 1);
+        var fragment = document.createDocumentFragment();
+        for(var index = first; index < last; ++index)
+        {
+            var row = element(fragment, 'div');
+            row.className = 'row';
+            row.style.top = index * rowHeight + 'px';
+            renderRow(row, index);
+        }
+        spacer.textContent = '';
+        spacer.appendChild(fragment);
+    }
+
+    function scheduleDraw()
+    {
+        if(!drawPending)
+        {
+            drawPending = true;
+            window.requestAnimationFrame(draw);
+        }
+    }
+
+    function showList(title, number, render)
+    {
+        heading.textContent = title;
+        rowNumber = number;
+        renderRow = render;
+        spacer.style.height = number * rowHeight + 'px';
+        list.scrollTop = 0;
+        draw();
+    }
+
+    list.addEventListener('scroll', scheduleDraw);
+    window.addEventListener('resize', scheduleDraw);
+
+    // Errors whose stack mention a value of a frame field
+    function selectErrors(field, value)
+    {
+        var selected = [];
+        for(var index = 0; index < errorNumber; ++index)
+        {
+            for(var rank = errors.stackOffsets[index]; rank < errors.stackOffsets[index + 1]; ++rank)
+            {
+                if(frames[6 * errors.stackFrames[rank] + field] === value)
+                {
+                    selected.push(index);
+                    break;
+                }
+            }
+        }
+        return selected;
+    }
+
+    function selectKind(kind)
+    {
+        var selected = [];
+        for(var index = 0; index < errorNumber; ++index)
+        {
+            if(errors.kind[index] === kind)
+            {
+                selected.push(index);
+            }
+        }
+        return selected;
+    }
+
+    function symbolAction(field, symbol, description)
+    {
+        if(!symbol)
+        {
+            return undefined;
+        }
+        return function()
+        {
+            showErrors('Errors whose call stack mention ' + description + ' ' + strings[symbol], selectErrors(field, symbol));
+        };
+    }
+
+    function kindAction(kind)
+    {
+        return function()
+        {
+            showErrors('Errors of kind ' + strings[kind], selectKind(kind));
+        };
+    }
+
+    function ipAction(ip)
+    {
+        return function()
+        {
+            showErrors('Errors whose call stack mention Frame ' + ip, selectErrors(0, ip));
+        };
+    }
+
+    function frameCells(parent, frame, tag)
+    {
+        var base = 6 * frame;
+        element(parent, tag, String(frames[base]), ipAction(frames[base]));
+        element(parent, tag, strings[frames[base + 1]], symbolAction(1, frames[base + 1], 'object'));
+        element(parent, tag, strings[frames[base + 2]], symbolAction(2, frames[base + 2], 'function'));
+        element(parent, tag, strings[frames[base + 3]], symbolAction(3, frames[base + 3], 'directory'));
+        element(parent, tag, strings[frames[base + 4]], symbolAction(4, frames[base + 4], 'file'));
+        element(parent, tag, frames[base + 5] ? String(frames[base + 5]) : '');
+    }
+
+    function showError(index)
+    {
+        detail.textContent = '';
+        element(detail, 'H3', 'Error ' + errorName(index));
+        var items = element(detail, 'ul');
+        if(multipleSources)
+        {
+            element(items, 'li', 'Log file : ' + data.sources[errors.source[index]][0]);
+        }
+        element(element(items, 'li', 'Kind : '), 'b', strings[errors.kind[index]], kindAction(errors.kind[index]));
+        if(strings[errors.what[index]])
+        {
+            element(items, 'li', 'What : ' + strings[errors.what[index]]);
+        }
+        if(strings[errors.auxWhat[index]])
+        {
+            element(items, 'li', 'Aux What : ' + strings[errors.auxWhat[index]]);
+        }
+        if(errors.xwhat[index] >= 0)
+        {
+            element(items, 'li', 'What : ' + strings[errors.xwhat[index]]);
+            element(items, 'li', 'Leaked bytes : ' + errors.leakedBytes[index] + ', leaked blocks : ' + errors.leakedBlocks[index]);
+        }
+        element(items, 'li', 'Tid : ' + errors.tid[index]);
+        var table = element(detail, 'table');
+        var header = element(table, 'tr');
+        ['Ip', 'Object', 'Function', 'Directory', 'File', 'Line'].forEach(function(title)
+        {
+            element(header, 'th', title);
+        });
+        for(var rank = errors.stackOffsets[index]; rank < errors.stackOffsets[index + 1]; ++rank)
+        {
+            frameCells(element(table, 'tr'), errors.stackFrames[rank], 'td');
+        }
+    }
+
+    function renderError(row, index)
+    {
+        element(row, 'span', 'Error ' + errorName(index), function()
+        {
+            showError(index);
+        });
+        element(row, 'span', strings[errors.kind[index]]);
+        element(row, 'span', strings[errors.xwhat[index] >= 0 ? errors.xwhat[index] : errors.what[index]]);
+    }
+
+    function showErrors(title, selected)
+    {
+        showList(title + ' (' + selected.length + ')', selected.length, function(row, index)
+        {
+            renderError(row, selected[index]);
+        });
+    }
+
+    function showSymbols(title, sorted, action)
+    {
+        showList(title, sorted.length / 2, function(row, index)
+        {
+            var symbol = sorted[2 * index];
+            element(row, 'span', strings[symbol], action(symbol));
+            element(row, 'span', String(sorted[2 * index + 1]));
+        });
+    }
+
+    var tabs =
+    [
+        ['Kinds', function()
+        {
+            showSymbols('Encountered kinds', data.sorted.kinds, kindAction);
+        }],
+        ['Files', function()
+        {
+            showSymbols('Encountered files', data.sorted.files, function(symbol)
+            {
+                return symbolAction(4, symbol, 'file');
+            });
+        }],
+        ['Objects', function()
+        {
+            showSymbols('Encountered Objects', data.sorted.objects, function(symbol)
+            {
+                return symbolAction(1, symbol, 'object');
+            });
+        }],
+        ['Functions', function()
+        {
+            showSymbols('Encountered Functions', data.sorted.functions, function(symbol)
+            {
+                return symbolAction(2, symbol, 'function');
+            });
+        }],
+        ['Directories', function()
+        {
+            showSymbols('Encountered Directories', data.sorted.directories, function(symbol)
+            {
+                return symbolAction(3, symbol, 'directory');
+            });
+        }],
+        ['Frames', function()
+        {
+            var sorted = data.sorted.frames;
+            showList('Encountered Frames', sorted.length / 2, function(row, index)
+            {
+                frameCells(row, sorted[2 * index], 'span');
+                element(row, 'span', String(sorted[2 * index + 1]));
+            });
+        }],
+        ['Error counts', function()
+        {
+            var sorted = data.sorted.errors;
+            showList('Encountered Errors', sorted.length / 2, function(row, index)
+            {
+                renderError(row, sorted[2 * index]);
+                element(row, 'span', String(sorted[2 * index + 1]));
+            });
+        }],
+        ['Errors', function()
+        {
+            showList('Errors (' + errorNumber + ')', errorNumber, renderError);
+        }]
+    ];
+    if(multipleSources)
+    {
+        tabs.push(['Log files', function()
+        {
+            showList('Log files', data.sources.length, function(row, index)
+            {
+                element(row, 'span', data.sources[index][0]);
+                element(row, 'span', 'pid ' + data.sources[index][1]);
+                element(row, 'span', data.sources[index][2] + ' errors');
+            });
+        }]);
+    }
+    var tabBar = document.getElementById('tabs');
+    tabs.forEach(function(tab)
+    {
+        var button = element(tabBar, 'button', tab[0]);
+        button.onclick = function()
+        {
+            Array.prototype.forEach.call(tabBar.children, function(other)
+            {
+                other.classList.remove('selected');
+            });
+            button.classList.add('selected');
+            tab[1]();
+        };
+    });
+    // Errors are shown first
+    tabBar.children[7].click();
+})();
+)viewer";
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_VIEWER_GENERATOR_H
+// EOF
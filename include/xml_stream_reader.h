@@ -0,0 +1,730 @@
+/*
+      This file is part of valgrind_log_tool
+      Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+
+      This program is free software: you can redistribute it and/or modify
+      it under the terms of the GNU General Public License as published by
+      the Free Software Foundation, either version 3 of the License, or
+      (at your option) any later version.
+
+      This program is distributed in the hope that it will be useful,
+      but WITHOUT ANY WARRANTY; without even the implied warranty of
+      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+      GNU General Public License for more details.
+
+      You should have received a copy of the GNU General Public License
+      along with this program.  If not, see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef VALGRIND_LOG_TOOL_XML_STREAM_READER_H
+#define VALGRIND_LOG_TOOL_XML_STREAM_READER_H
+
+#include "quicky_exception.h"
+#include "string_ref.h"
+#include "number_parser.h"
+#include <istream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+namespace valgrind_log_tool
+{
+    /**
+     * Pull parser reading an XML document from a stream through a bounded
+     * buffer: only the token being decoded is kept in memory whatever the
+     * size of the document. Document can also be read from memory, in this
+     * case texts refer directly to it when they contain no entity.
+     * It supports the XML subset produced by valgrind: elements, text,
+     * character and predefined entities, comments, CDATA sections and
+     * processing instructions. Attributes are skipped.
+     * Text made only of white spaces is not reported
+     */
+    class xml_stream_reader
+    {
+      public:
+
+        enum class t_event
+        { start_element
+        , end_element
+        , text
+        , end_of_document
+        };
+
+        inline
+        xml_stream_reader( std::istream & p_stream
+                         , const std::string & p_stream_name
+                         );
+
+        inline
+        xml_stream_reader( const char * p_begin
+                         , const char * p_end
+                         , const std::string & p_stream_name
+                         );
+
+        /**
+         * Read a fragment of a document located in memory
+         * @param p_begin first character of fragment
+         * @param p_end end of fragment
+         * @param p_stream_name name of document used in error messages
+         * @param p_open_element name of root element if it has been opened
+         * before fragment, empty if fragment starts document
+         * @param p_last_fragment true if fragment ends document. Otherwise
+         * fragment must end while root element is the only open element and
+         * end_of_document is returned at this point
+         */
+        inline
+        xml_stream_reader( const char * p_begin
+                         , const char * p_end
+                         , const std::string & p_stream_name
+                         , const std::string & p_open_element
+                         , bool p_last_fragment
+                         );
+
+        /**
+         * Read next event from stream. Once root element is closed
+         * end_of_document is returned without reading the rest of stream
+         * @return kind of event that has been read
+         */
+        inline
+        t_event next();
+
+        /**
+         * @return name of element for start_element and end_element events.
+         * Referenced characters are valid until next call to next()
+         */
+        inline
+        const string_ref & get_name() const;
+
+        /**
+         * @return decoded text for text events. Referenced characters are
+         * valid until next call to next() unless text is persistent
+         */
+        inline
+        const string_ref & get_text() const;
+
+        /**
+         * @return true if text references document located in memory and
+         * stays valid as long as this memory
+         */
+        inline
+        bool is_text_persistent() const;
+
+      private:
+
+        /**
+         * Read more data from stream, moving unconsumed data at the beginning
+         * of buffer and growing it if a token does not fit
+         * @return false if there is no more data to read
+         */
+        inline
+        bool fill();
+
+        /**
+         * Search pattern in unconsumed data, reading stream if needed
+         * @param p_pattern pattern to search
+         * @param p_from offset relative to first unconsumed character
+         * @param p_eof_allowed if true reaching end of stream is not an error
+         * @return offset of pattern relative to first unconsumed character
+         * or number of unconsumed characters if end of stream is reached
+         */
+        inline
+        size_t find( const char * p_pattern
+                   , size_t p_from
+                   , bool p_eof_allowed = false
+                   );
+
+        /**
+         * Search end of start tag taking care of quoted attribute values
+         * @return offset of '>' relative to first unconsumed character
+         */
+        inline
+        size_t find_tag_end();
+
+        /**
+         * Check that a given number of characters is available
+         */
+        inline
+        bool ensure(size_t p_size);
+
+        /**
+         * Set text replacing entities by their value
+         */
+        inline
+        void decode( const char * p_begin
+                   , const char * p_end
+                   );
+
+        inline
+        void append_utf8( uint32_t p_code_point
+                        , std::string & p_result
+                        ) const;
+
+        /**
+         * Extract element name from tag content
+         */
+        inline
+        string_ref extract_name( const char * p_begin
+                               , const char * p_end
+                               ) const;
+
+        /**
+         * Update line and column counters up to a position in buffer
+         */
+        inline
+        void count_lines(size_t p_position);
+
+        [[noreturn]] inline
+        void throw_error(const std::string & p_message);
+
+        /**
+         * Stream to read, null when document is located in memory
+         */
+        std::istream * m_stream;
+        std::string m_stream_name;
+
+        std::vector<char> m_buffer;
+
+        /**
+         * Document characters: either buffer content or document in memory
+         */
+        const char * m_data;
+
+        /**
+         * Index of first unconsumed character in buffer
+         */
+        size_t m_begin;
+
+        /**
+         * Index following last character read from stream
+         */
+        size_t m_end;
+
+        bool m_eof;
+
+        /**
+         * Set if end of data is accepted while root element is open
+         */
+        bool m_open_end;
+
+        /**
+         * Indicate that an end_element event must be emitted for a self closing tag
+         */
+        bool m_pending_end;
+
+        /**
+         * Names of open elements. Strings are reused from one element to
+         * another to avoid allocations
+         */
+        std::vector<std::string> m_elements;
+
+        /**
+         * Number of open elements
+         */
+        size_t m_depth;
+
+        /**
+         * Set once root element has been closed
+         */
+        bool m_document_end;
+
+        string_ref m_name;
+
+        /**
+         * Storage of text when it cannot directly reference document
+         */
+        std::string m_decoded_text;
+        string_ref m_text;
+        bool m_text_persistent;
+
+        /**
+         * Index in buffer up to which lines have been counted
+         */
+        size_t m_counted;
+        unsigned int m_line;
+        unsigned int m_column;
+
+        static const size_t m_chunk_size = 1 << 16;
+    };
+
+    //-------------------------------------------------------------------------
+    xml_stream_reader::xml_stream_reader( std::istream & p_stream
+                                        , const std::string & p_stream_name
+                                        )
+    : m_stream(&p_stream)
+    , m_stream_name(p_stream_name)
+    , m_buffer(m_chunk_size)
+    , m_data(m_buffer.data())
+    , m_begin(0)
+    , m_end(0)
+    , m_eof(false)
+    , m_open_end(false)
+    , m_pending_end(false)
+    , m_depth(0)
+    , m_document_end(false)
+    , m_text_persistent(false)
+    , m_counted(0)
+    , m_line(1)
+    , m_column(1)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    xml_stream_reader::xml_stream_reader( const char * p_begin
+                                        , const char * p_end
+                                        , const std::string & p_stream_name
+                                        )
+    : m_stream(nullptr)
+    , m_stream_name(p_stream_name)
+    , m_data(p_begin)
+    , m_begin(0)
+    , m_end(p_end - p_begin)
+    , m_eof(true)
+    , m_open_end(false)
+    , m_pending_end(false)
+    , m_depth(0)
+    , m_document_end(false)
+    , m_text_persistent(false)
+    , m_counted(0)
+    , m_line(1)
+    , m_column(1)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    xml_stream_reader::xml_stream_reader( const char * p_begin
+                                        , const char * p_end
+                                        , const std::string & p_stream_name
+                                        , const std::string & p_open_element
+                                        , bool p_last_fragment
+                                        )
+    : xml_stream_reader(p_begin, p_end, p_stream_name)
+    {
+        m_open_end = !p_last_fragment;
+        if(!p_open_element.empty())
+        {
+            m_elements.push_back(p_open_element);
+            m_depth = 1;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    xml_stream_reader::t_event
+    xml_stream_reader::next()
+    {
+        if(m_pending_end)
+        {
+            m_pending_end = false;
+            --m_depth;
+            m_document_end = !m_depth;
+            return t_event::end_element;
+        }
+        while(!m_document_end)
+        {
+            if(m_begin == m_end && !fill())
+            {
+                if(m_open_end && 1 == m_depth)
+                {
+                    m_document_end = true;
+                    break;
+                }
+                if(m_depth)
+                {
+                    throw_error("Unexpected end of file, element \"" + m_elements[m_depth - 1] + "\" is not closed");
+                }
+                throw_error("No root element");
+            }
+            const char * l_data = m_data + m_begin;
+            if('<' != *l_data)
+            {
+                size_t l_end = find("<", 0, true);
+                l_data = m_data + m_begin;
+                const char * l_text_end = l_data + l_end;
+                const char * l_iter = l_data;
+                while(l_iter < l_text_end && (' ' == *l_iter || '\n' == *l_iter || '\t' == *l_iter || '\r' == *l_iter))
+                {
+                    ++l_iter;
+                }
+                if(l_iter == l_text_end)
+                {
+                    m_begin += l_end;
+                    continue;
+                }
+                if(!m_depth)
+                {
+                    throw_error("Text outside of root element");
+                }
+                decode(l_data, l_text_end);
+                m_begin += l_end;
+                return t_event::text;
+            }
+            if(!ensure(2))
+            {
+                throw_error("Unexpected end of file");
+            }
+            l_data = m_data + m_begin;
+            switch(l_data[1])
+            {
+                case '/':
+                {
+                    size_t l_end = find(">", 2);
+                    l_data = m_data + m_begin;
+                    string_ref l_name = extract_name(l_data + 2, l_data + l_end);
+                    if(!m_depth || string_ref(m_elements[m_depth - 1]) != l_name)
+                    {
+                        throw_error("Closing tag \"" + l_name.str() + "\" does not match " + (!m_depth ? std::string("any open element") : "open element \"" + m_elements[m_depth - 1] + "\""));
+                    }
+                    --m_depth;
+                    m_name = string_ref(m_elements[m_depth]);
+                    m_document_end = !m_depth;
+                    m_begin += l_end + 1;
+                    return t_event::end_element;
+                }
+                case '?':
+                {
+                    m_begin += find("?>", 2) + 2;
+                    break;
+                }
+                case '!':
+                {
+                    if(ensure(4) && !strncmp(m_data + m_begin, "<!--", 4))
+                    {
+                        m_begin += find("-->", 4) + 3;
+                    }
+                    else if(ensure(9) && !strncmp(m_data + m_begin, "<![CDATA[", 9))
+                    {
+                        size_t l_end = find("]]>", 9);
+                        if(!m_depth)
+                        {
+                            throw_error("CDATA section outside of root element");
+                        }
+                        l_data = m_data + m_begin;
+                        m_text = string_ref(l_data + 9, l_end - 9);
+                        m_text_persistent = !m_stream;
+                        m_begin += l_end + 3;
+                        return t_event::text;
+                    }
+                    else
+                    {
+                        m_begin += find(">", 2) + 1;
+                    }
+                    break;
+                }
+                default:
+                {
+                    size_t l_end = find_tag_end();
+                    l_data = m_data + m_begin;
+                    m_pending_end = '/' == l_data[l_end - 1];
+                    string_ref l_name = extract_name(l_data + 1, l_data + l_end - (m_pending_end ? 1 : 0));
+                    if(l_name.empty())
+                    {
+                        throw_error("Missing element name");
+                    }
+                    if(m_elements.size() == m_depth)
+                    {
+                        m_elements.emplace_back();
+                    }
+                    m_elements[m_depth].assign(l_name.data(), l_name.size());
+                    m_name = string_ref(m_elements[m_depth]);
+                    ++m_depth;
+                    m_begin += l_end + 1;
+                    return t_event::start_element;
+                }
+            }
+        }
+        return t_event::end_of_document;
+    }
+
+    //-------------------------------------------------------------------------
+    const string_ref &
+    xml_stream_reader::get_name() const
+    {
+        return m_name;
+    }
+
+    //-------------------------------------------------------------------------
+    const string_ref &
+    xml_stream_reader::get_text() const
+    {
+        return m_text;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    xml_stream_reader::is_text_persistent() const
+    {
+        return m_text_persistent;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    xml_stream_reader::fill()
+    {
+        if(m_eof)
+        {
+            return false;
+        }
+        assert(m_stream);
+        if(m_begin)
+        {
+            count_lines(m_begin);
+            std::memmove(m_buffer.data(), m_data + m_begin, m_end - m_begin);
+            m_end -= m_begin;
+            m_counted -= m_begin;
+            m_begin = 0;
+        }
+        if(m_buffer.size() - m_end < m_chunk_size)
+        {
+            m_buffer.resize(m_end + m_chunk_size);
+            m_data = m_buffer.data();
+        }
+        std::streamsize l_read = m_stream->rdbuf()->sgetn(m_buffer.data() + m_end, m_buffer.size() - m_end);
+        if(l_read <= 0)
+        {
+            m_eof = true;
+            return false;
+        }
+        m_end += l_read;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool
+    xml_stream_reader::ensure(size_t p_size)
+    {
+        while(m_end - m_begin < p_size)
+        {
+            if(!fill())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    xml_stream_reader::find( const char * p_pattern
+                           , size_t p_from
+                           , bool p_eof_allowed
+                           )
+    {
+        size_t l_pattern_size = strlen(p_pattern);
+        for(;;)
+        {
+            const char * l_begin = m_data + m_begin;
+            const char * l_end = m_data + m_end;
+            const char * l_iter = l_begin + p_from;
+            while(nullptr != (l_iter = static_cast<const char *>(memchr(l_iter, *p_pattern, l_end - l_iter))))
+            {
+                if(static_cast<size_t>(l_end - l_iter) < l_pattern_size)
+                {
+                    break;
+                }
+                if(!memcmp(l_iter, p_pattern, l_pattern_size))
+                {
+                    return l_iter - l_begin;
+                }
+                ++l_iter;
+            }
+            // Pattern may start in the last characters already read
+            size_t l_size = m_end - m_begin;
+            p_from = l_size >= l_pattern_size ? l_size - l_pattern_size + 1 : 0;
+            if(!fill())
+            {
+                if(p_eof_allowed)
+                {
+                    return m_end - m_begin;
+                }
+                throw_error("Unexpected end of file while searching \"" + std::string(p_pattern) + "\"");
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    size_t
+    xml_stream_reader::find_tag_end()
+    {
+        size_t l_index = 1;
+        char l_quote = '\0';
+        for(;;)
+        {
+            for(; m_begin + l_index < m_end; ++l_index)
+            {
+                char l_char = m_data[m_begin + l_index];
+                if(l_quote)
+                {
+                    if(l_char == l_quote)
+                    {
+                        l_quote = '\0';
+                    }
+                }
+                else if('>' == l_char)
+                {
+                    return l_index;
+                }
+                else if('"' == l_char || '\'' == l_char)
+                {
+                    l_quote = l_char;
+                }
+            }
+            if(!fill())
+            {
+                throw_error("Unexpected end of file in tag");
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    string_ref
+    xml_stream_reader::extract_name( const char * p_begin
+                                   , const char * p_end
+                                   ) const
+    {
+        const char * l_end = p_begin;
+        while(l_end < p_end && ' ' != *l_end && '\n' != *l_end && '\t' != *l_end && '\r' != *l_end)
+        {
+            ++l_end;
+        }
+        return string_ref(p_begin, l_end - p_begin);
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    xml_stream_reader::decode( const char * p_begin
+                             , const char * p_end
+                             )
+    {
+        const char * l_amp = static_cast<const char *>(memchr(p_begin, '&', p_end - p_begin));
+        if(!l_amp)
+        {
+            m_text = string_ref(p_begin, p_end - p_begin);
+            m_text_persistent = !m_stream;
+            return;
+        }
+        m_decoded_text.assign(p_begin, l_amp);
+        while(l_amp)
+        {
+            const char * l_semicolon = static_cast<const char *>(memchr(l_amp, ';', p_end - l_amp));
+            if(!l_semicolon)
+            {
+                throw_error("Unterminated entity in \"" + std::string(p_begin, p_end) + "\"");
+            }
+            std::string l_entity(l_amp + 1, l_semicolon);
+            if("lt" == l_entity)
+            {
+                m_decoded_text += '<';
+            }
+            else if("gt" == l_entity)
+            {
+                m_decoded_text += '>';
+            }
+            else if("amp" == l_entity)
+            {
+                m_decoded_text += '&';
+            }
+            else if("quot" == l_entity)
+            {
+                m_decoded_text += '"';
+            }
+            else if("apos" == l_entity)
+            {
+                m_decoded_text += '\'';
+            }
+            else if(l_entity.size() > 1 && '#' == l_entity[0])
+            {
+                bool l_hexa = 'x' == l_entity[1];
+                const char * l_digits = l_amp + (l_hexa ? 3 : 2);
+                uint64_t l_code_point = 0;
+                // Only code points of XML characters can be encoded in UTF-8
+                if(l_digits == l_semicolon
+                   || !(l_hexa ? parse_hexadecimal(l_digits, l_semicolon, l_code_point) : parse_decimal(l_digits, l_semicolon, l_code_point))
+                   || !l_code_point
+                   || l_code_point > 0x10FFFF
+                   || (0xD800 <= l_code_point && l_code_point <= 0xDFFF)
+                  )
+                {
+                    throw_error("Invalid character reference \"&" + l_entity + ";\"");
+                }
+                append_utf8(static_cast<uint32_t>(l_code_point), m_decoded_text);
+            }
+            else
+            {
+                throw_error("Unknown entity \"&" + l_entity + ";\"");
+            }
+            const char * l_next = l_semicolon + 1;
+            l_amp = static_cast<const char *>(memchr(l_next, '&', p_end - l_next));
+            m_decoded_text.append(l_next, l_amp ? l_amp : p_end);
+        }
+        m_text = string_ref(m_decoded_text);
+        m_text_persistent = false;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    xml_stream_reader::append_utf8( uint32_t p_code_point
+                                  , std::string & p_result
+                                  ) const
+    {
+        if(p_code_point < 0x80)
+        {
+            p_result += static_cast<char>(p_code_point);
+        }
+        else if(p_code_point < 0x800)
+        {
+            p_result += static_cast<char>(0xC0 | (p_code_point >> 6));
+            p_result += static_cast<char>(0x80 | (p_code_point & 0x3F));
+        }
+        else if(p_code_point < 0x10000)
+        {
+            p_result += static_cast<char>(0xE0 | (p_code_point >> 12));
+            p_result += static_cast<char>(0x80 | ((p_code_point >> 6) & 0x3F));
+            p_result += static_cast<char>(0x80 | (p_code_point & 0x3F));
+        }
+        else
+        {
+            p_result += static_cast<char>(0xF0 | (p_code_point >> 18));
+            p_result += static_cast<char>(0x80 | ((p_code_point >> 12) & 0x3F));
+            p_result += static_cast<char>(0x80 | ((p_code_point >> 6) & 0x3F));
+            p_result += static_cast<char>(0x80 | (p_code_point & 0x3F));
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    xml_stream_reader::count_lines(size_t p_position)
+    {
+        const char * l_iter = m_data + m_counted;
+        const char * l_end = m_data + p_position;
+        const char * l_line_start = nullptr;
+        while(nullptr != (l_iter = static_cast<const char *>(memchr(l_iter, '\n', l_end - l_iter))))
+        {
+            ++m_line;
+            l_line_start = ++l_iter;
+        }
+        if(l_line_start)
+        {
+            m_column = 1 + (l_end - l_line_start);
+        }
+        else
+        {
+            m_column += p_position - m_counted;
+        }
+        m_counted = p_position;
+    }
+
+    //-------------------------------------------------------------------------
+    void
+    xml_stream_reader::throw_error(const std::string & p_message)
+    {
+        count_lines(m_begin);
+        throw quicky_exception::quicky_logic_exception( "\"" + p_message + "\" at line " + std::to_string(m_line) + " and column " + std::to_string(m_column) + " of file \"" + m_stream_name + "\""
+                                                      , __LINE__
+                                                      , __FILE__
+                                                      );
+    }
+
+}
+#endif //VALGRIND_LOG_TOOL_XML_STREAM_READER_H
+// EOF
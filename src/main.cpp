@@ -16,31 +16,355 @@
       along with this program.  If not, see <http://www.gnu.org/licenses/>
 */
 
-#include "valgrind_log_parser.h"
+#include "valgrind_log_batch.h"
+#include "follow_streambuf.h"
+#include "compressed_streambuf.h"
+#include "valgrind_log_listener.h"
+#include "valgrind_log_statistics.h"
 #include "html_generator.h"
+#include "viewer_generator.h"
+#include "json_generator.h"
+#include "csv_generator.h"
+#include "markdown_generator.h"
 #include "quicky_exception.h"
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <csignal>
+
+/**
+ * Set when an interruption signal is received in listening or follow mode
+ */
+static volatile std::sig_atomic_t g_interrupted = 0;
+
+static void interrupt(int)
+{
+    g_interrupted = 1;
+}
 
 int main(int p_argc, char ** p_argv)
 {
     try
     {
-        assert(2 == p_argc);
-        std::string l_file_name{p_argv[1]};
-        std::ifstream l_input_file;
-        l_input_file.open(l_file_name);
-        if(!l_input_file.is_open())
+        std::vector<std::string> l_names;
+        bool l_stats = false;
+        bool l_follow = false;
+        // Report name per format, pages are written in a directory to keep
+        // their index beside them
+        const std::map<std::string, std::string> l_report_names{{"html", "valgrind.html"}
+                                                               ,{"pages", "valgrind_report"}
+                                                               ,{"viewer", "valgrind_viewer.html"}
+                                                               ,{"json", "valgrind.json"}
+                                                               ,{"csv", "valgrind.csv"}
+                                                               ,{"markdown", "valgrind.md"}
+                                                               };
+        // Reports written from the same statistics, html by default
+        std::vector<std::string> l_formats;
+        bool l_compressed = false;
+        unsigned int l_interval = 10;
+        // 0 to follow log until it is complete or interrupted
+        unsigned int l_timeout = 0;
+        std::string l_listen_address;
+        unsigned int l_connection_number = 0;
+        // 0 until option --jobs is met
+        unsigned int l_jobs = 0;
+        valgrind_log_tool::valgrind_log_parser::t_input_mode l_input_mode = valgrind_log_tool::valgrind_log_parser::t_input_mode::mapped;
+        for(int l_index = 1; l_index < p_argc; ++l_index)
+        {
+            std::string l_argument{p_argv[l_index]};
+            if("--dom" == l_argument)
+            {
+                l_input_mode = valgrind_log_tool::valgrind_log_parser::t_input_mode::dom;
+            }
+            else if("--connections" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing number of connections after \"--connections\"", __LINE__, __FILE__);
+                }
+                std::string l_connections_argument{p_argv[l_index]};
+                l_connection_number = valgrind_log_tool::parse_number<unsigned int>(valgrind_log_tool::string_ref(l_connections_argument));
+            }
+            else if("--follow" == l_argument)
+            {
+                l_follow = true;
+            }
+            else if("--format" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing format after \"--format\"", __LINE__, __FILE__);
+                }
+                std::string l_format{p_argv[l_index]};
+                if(!l_report_names.count(l_format))
+                {
+                    throw quicky_exception::quicky_logic_exception("Unknown format \"" + l_format + "\"", __LINE__, __FILE__);
+                }
+                if(l_formats.end() == std::find(l_formats.begin(), l_formats.end(), l_format))
+                {
+                    l_formats.push_back(l_format);
+                }
+            }
+            else if("--gzip" == l_argument)
+            {
+                l_compressed = true;
+            }
+            else if("--interval" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing number of seconds after \"--interval\"", __LINE__, __FILE__);
+                }
+                std::string l_interval_argument{p_argv[l_index]};
+                l_interval = valgrind_log_tool::parse_number<unsigned int>(valgrind_log_tool::string_ref(l_interval_argument));
+            }
+            else if("--jobs" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing number of jobs after \"--jobs\"", __LINE__, __FILE__);
+                }
+                std::string l_jobs_argument{p_argv[l_index]};
+                l_jobs = valgrind_log_tool::parse_number<unsigned int>(valgrind_log_tool::string_ref(l_jobs_argument));
+                if(!l_jobs)
+                {
+                    throw quicky_exception::quicky_logic_exception("Number of jobs should be at least 1", __LINE__, __FILE__);
+                }
+            }
+            else if("--listen" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing port after \"--listen\"", __LINE__, __FILE__);
+                }
+                l_listen_address = p_argv[l_index];
+            }
+            else if("--pages" == l_argument)
+            {
+                if(l_formats.end() == std::find(l_formats.begin(), l_formats.end(), "pages"))
+                {
+                    l_formats.push_back("pages");
+                }
+            }
+            else if("--stats" == l_argument)
+            {
+                l_stats = true;
+            }
+            else if("--stream" == l_argument)
+            {
+                l_input_mode = valgrind_log_tool::valgrind_log_parser::t_input_mode::stream;
+            }
+            else if("--timeout" == l_argument)
+            {
+                if(++l_index == p_argc)
+                {
+                    throw quicky_exception::quicky_logic_exception("Missing number of seconds after \"--timeout\"", __LINE__, __FILE__);
+                }
+                std::string l_timeout_argument{p_argv[l_index]};
+                l_timeout = valgrind_log_tool::parse_number<unsigned int>(valgrind_log_tool::string_ref(l_timeout_argument));
+            }
+            else if("--viewer" == l_argument)
+            {
+                if(l_formats.end() == std::find(l_formats.begin(), l_formats.end(), "viewer"))
+                {
+                    l_formats.push_back("viewer");
+                }
+            }
+            else if("--" == l_argument.substr(0, 2))
+            {
+                throw quicky_exception::quicky_logic_exception("Unknown option \"" + l_argument + "\"", __LINE__, __FILE__);
+            }
+            else
+            {
+                l_names.push_back(l_argument);
+            }
+        }
+        if(l_names.empty() == l_listen_address.empty())
+        {
+            throw quicky_exception::quicky_logic_exception("Usage: valgrind_log_tool [--dom|--stream] [--jobs <N>] [--format <format>]... [--pages] [--viewer] [--gzip] [--stats] <valgrind XML log or directory>...\n"
+                                                           "       valgrind_log_tool --follow [--interval <seconds>] [--timeout <seconds>] [--format <format>]... [--viewer] [--gzip] [--stats] <valgrind XML log>\n"
+                                                           "       valgrind_log_tool --listen [<address>:]<port> [--connections <N>] [--interval <seconds>] [--format <format>]... [--viewer] [--gzip] [--stats]\n"
+                                                           "Formats: html, pages, viewer, json, csv, markdown"
+                                                          , __LINE__
+                                                          , __FILE__
+                                                          );
+        }
+        if(l_formats.empty())
+        {
+            l_formats.push_back("html");
+        }
+        bool l_pages = l_formats.end() != std::find(l_formats.begin(), l_formats.end(), "pages");
+        if(!l_listen_address.empty() && (l_follow || l_jobs || l_pages || valgrind_log_tool::valgrind_log_parser::t_input_mode::mapped != l_input_mode))
+        {
+            throw quicky_exception::quicky_logic_exception("Option \"--listen\" cannot be combined with \"--follow\", \"--jobs\", \"--pages\", \"--dom\" or \"--stream\"", __LINE__, __FILE__);
+        }
+        std::vector<std::string> l_file_names = valgrind_log_tool::valgrind_log_batch::expand(l_names);
+        for(const auto & l_file_name: l_file_names)
+        {
+            std::ifstream l_input_file;
+            l_input_file.open(l_file_name);
+            if(!l_input_file.is_open())
+            {
+                throw quicky_exception::quicky_logic_exception("Unable to open file \"" + l_file_name +"\"", __LINE__, __FILE__);
+            }
+            l_input_file.close();
+        }
+        if(!l_jobs)
+        {
+            // A single log is parsed sequentially unless asked, several logs use all cores
+            l_jobs = 1 == l_file_names.size() ? 1 : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        if(l_follow && (1 != l_file_names.size() || valgrind_log_tool::valgrind_log_parser::t_input_mode::mapped != l_input_mode || l_jobs > 1 || l_pages))
         {
-            throw quicky_exception::quicky_logic_exception("Unable to open file \"" + l_file_name +"\"", __LINE__, __FILE__);
+            throw quicky_exception::quicky_logic_exception("Option \"--follow\" only supports a single log file without \"--dom\", \"--stream\", \"--jobs\" or \"--pages\"", __LINE__, __FILE__);
+        }
+        // Compressed data cannot be decompressed while it is still being written
+        if(l_follow && valgrind_log_tool::compressed_streambuf::t_format::none != valgrind_log_tool::compressed_streambuf::get_format(l_file_names.front()))
+        {
+            throw quicky_exception::quicky_logic_exception("Option \"--follow\" does not support compressed log \"" + l_file_names.front() + "\"", __LINE__, __FILE__);
         }
-        l_input_file.close();
 
+        const auto l_get_report_name = [&](const std::string & p_format) -> std::string
+        {
+            const std::string & l_name = l_report_names.at(p_format);
+            return l_compressed && "pages" != p_format ? l_name + ".gz" : l_name;
+        };
+        const auto l_create_generator = [&]( const std::string & p_format
+                                           , const std::string & p_file_name
+                                           ) -> std::unique_ptr<valgrind_log_tool::report_generator>
+        {
+            if("viewer" == p_format)
+            {
+                return std::unique_ptr<valgrind_log_tool::report_generator>(new valgrind_log_tool::viewer_generator(p_file_name, l_jobs, l_compressed));
+            }
+            if("json" == p_format)
+            {
+                return std::unique_ptr<valgrind_log_tool::report_generator>(new valgrind_log_tool::json_generator(p_file_name, l_jobs, l_compressed));
+            }
+            if("csv" == p_format)
+            {
+                return std::unique_ptr<valgrind_log_tool::report_generator>(new valgrind_log_tool::csv_generator(p_file_name, l_jobs, l_compressed));
+            }
+            if("markdown" == p_format)
+            {
+                return std::unique_ptr<valgrind_log_tool::report_generator>(new valgrind_log_tool::markdown_generator(p_file_name, l_jobs, l_compressed));
+            }
+            return std::unique_ptr<valgrind_log_tool::report_generator>(new valgrind_log_tool::html_generator(p_file_name, l_jobs, "pages" == p_format, l_compressed));
+        };
         valgrind_log_tool::valgrind_log_content l_content;
-        valgrind_log_tool::valgrind_log_parser l_parser(l_file_name, l_content);
-        valgrind_log_tool::html_generator l_generator("valgrind.html");
-        l_generator.generate(l_content);
+        std::chrono::duration<double> l_aggregation_duration;
+        std::chrono::duration<double> l_generation_duration;
+        size_t l_stack_number = 0;
+        // Statistics are aggregated once for all reports
+        const auto l_write_reports = [&](const std::string & p_suffix)
+        {
+            auto l_aggregation_start = std::chrono::steady_clock::now();
+            valgrind_log_tool::valgrind_log_statistics l_statistics(l_content, l_jobs);
+            l_stack_number = l_statistics.get_stack_number();
+            auto l_generation_start = std::chrono::steady_clock::now();
+            for(const auto & l_format: l_formats)
+            {
+                l_create_generator(l_format, l_get_report_name(l_format) + p_suffix)->generate(l_content, l_statistics);
+            }
+            l_aggregation_duration = l_generation_start - l_aggregation_start;
+            l_generation_duration = std::chrono::steady_clock::now() - l_generation_start;
+        };
+        // Reports are written beside then renamed so that reports being
+        // read are always complete
+        const auto l_update_reports = [&]()
+        {
+            l_write_reports(".tmp");
+            for(const auto & l_format: l_formats)
+            {
+                std::string l_report_name = l_get_report_name(l_format);
+                if(rename((l_report_name + ".tmp").c_str(), l_report_name.c_str()))
+                {
+                    throw quicky_exception::quicky_runtime_exception("Unable to update \"" + l_report_name + "\"", __LINE__, __FILE__);
+                }
+            }
+            std::cout << "Report updated with " << l_content.get_error_number() << " errors" << std::endl;
+        };
+        // While logs are received, reports are updated if new errors arrived
+        // since interval
+        auto l_report_time = std::chrono::steady_clock::now();
+        size_t l_reported_error_number = 0;
+        const auto l_update_reports_periodically = [&]()
+        {
+            auto l_now = std::chrono::steady_clock::now();
+            if(l_content.get_error_number() != l_reported_error_number && l_now - l_report_time >= std::chrono::seconds(l_interval))
+            {
+                l_update_reports();
+                l_reported_error_number = l_content.get_error_number();
+                l_report_time = l_now;
+            }
+        };
+        auto l_start = std::chrono::steady_clock::now();
+        uint64_t l_node_number;
+        if(!l_listen_address.empty())
+        {
+            valgrind_log_tool::valgrind_log_listener l_listener(l_listen_address, l_content);
+            std::signal(SIGINT, interrupt);
+            std::signal(SIGTERM, interrupt);
+            std::cout << "Listening on " << l_listen_address << std::endl;
+            l_listener.run(l_connection_number, [&](){return g_interrupted;}, l_update_reports_periodically);
+            l_node_number = l_listener.get_node_number();
+        }
+        else if(l_follow)
+        {
+            // When there is no more data to read, report is updated if new
+            // errors arrived since interval. Following stops if interrupted
+            std::signal(SIGINT, interrupt);
+            std::signal(SIGTERM, interrupt);
+            const auto l_wait = [&]()
+            {
+                l_update_reports_periodically();
+                return !g_interrupted;
+            };
+            valgrind_log_tool::follow_streambuf l_buffer(l_file_names.front(), l_wait, std::chrono::seconds(l_timeout));
+            std::istream l_stream(&l_buffer);
+            try
+            {
+                valgrind_log_tool::valgrind_log_parser l_parser(l_stream, l_content.add_source(l_file_names.front()), l_content, &l_node_number);
+            }
+            catch(const quicky_exception::quicky_logic_exception & e)
+            {
+                if(!l_buffer.is_stopped())
+                {
+                    throw;
+                }
+                // Errors completely read are kept in final report
+                std::cout << "Log " << l_file_names.front() << " : " << e.what() << std::endl;
+            }
+        }
+        else
+        {
+            valgrind_log_tool::valgrind_log_batch l_batch(l_file_names, l_content, l_input_mode, l_jobs);
+            l_node_number = l_batch.get_node_number();
+        }
+        if(l_stats)
+        {
+            std::chrono::duration<double> l_duration = std::chrono::steady_clock::now() - l_start;
+            std::cout << "Parsing: " << l_content.get_source_number() << " log(s), " << l_node_number << " nodes in " << l_duration.count() * 1000 << " ms";
+            if(l_node_number)
+            {
+                std::cout << " (" << l_duration.count() * 1e9 / l_node_number << " ns per node)";
+            }
+            std::cout << std::endl;
+            std::cout << "Records: " << l_content.get_error_number() << " errors, " << l_content.get_errors().get_stack_frames().size() << " stack entries, " << l_content.get_frames().get_size() << " frames, " << l_content.get_symbol_number() << " symbols" << std::endl;
+        }
+        l_write_reports("");
+        if(l_stats)
+        {
+            std::cout << "Report: aggregation with " << l_jobs << " thread(s) in " << l_aggregation_duration.count() * 1000 << " ms, generation in " << l_generation_duration.count() * 1000 << " ms, " << l_stack_number << " distinct call stacks for " << l_content.get_error_number() << " errors" << std::endl;
+        }
     }
     catch(const quicky_exception::quicky_logic_exception & e)
     {
@@ -0,0 +1,83 @@
+#!/bin/bash
+#
+#     This file is part of valgrind_log_tool
+#     Copyright (C) 2020  Julien Thevenon ( julien_thevenon at yahoo.fr )
+#
+#     This program is free software: you can redistribute it and/or modify
+#     it under the terms of the GNU General Public License as published by
+#     the Free Software Foundation, either version 3 of the License, or
+#     (at your option) any later version.
+#
+#     This program is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#     GNU General Public License for more details.
+#
+#     You should have received a copy of the GNU General Public License
+#     along with this program.  If not, see <http://www.gnu.org/licenses/>
+#
+# Check that errors of a connection still open are reported, and that a
+# listener interrupted while a connection is still open stops normally and
+# writes the final report with errors already received.
+#
+# Usage: check_listener.sh binary [port]
+
+set -e
+
+if [ $# -eq 0 ]
+then
+    echo "Usage: $0 binary [port]" >&2
+    exit 1
+fi
+BINARY=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+PORT=${2:-$((20000 + RANDOM % 20000))}
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+python3 "$TEST_DIR/../bench/generate_log.py" --errors 100 > "$WORK_DIR/log.xml"
+head -c $(($(stat -c %s "$WORK_DIR/log.xml") / 2)) "$WORK_DIR/log.xml" > "$WORK_DIR/half.xml"
+
+(cd "$WORK_DIR" && exec "$BINARY" --listen "$PORT" --interval 0) > "$WORK_DIR/output.txt" &
+LISTENER=$!
+for RETRY in $(seq 50)
+do
+    grep -q "^Listening" "$WORK_DIR/output.txt" && break
+    sleep 0.1
+done
+
+# Half of a log left open then a complete log
+exec 3<> "/dev/tcp/127.0.0.1/$PORT"
+cat "$WORK_DIR/half.xml" >&3
+for RETRY in $(seq 50)
+do
+    grep -q "^Report updated" "$WORK_DIR/output.txt" && break
+    sleep 0.1
+done
+if ! grep -q "^Report updated with [1-9]" "$WORK_DIR/output.txt"
+then
+    cat "$WORK_DIR/output.txt"
+    echo "Errors of open connection are not reported" >&2
+    kill "$LISTENER"
+    exit 1
+fi
+cat "$WORK_DIR/log.xml" > "/dev/tcp/127.0.0.1/$PORT"
+sleep 0.5
+
+kill -INT "$LISTENER"
+STATUS=0
+wait "$LISTENER" || STATUS=$?
+exec 3>&-
+cat "$WORK_DIR/output.txt"
+
+if [ $STATUS -ne 0 ]
+then
+    echo "Listener exited with status $STATUS" >&2
+    exit 1
+fi
+if ! grep -q "InvalidRead\|InvalidWrite\|UninitCondition\|Leak_" "$WORK_DIR/valgrind.html"
+then
+    echo "Final report does not contain received errors" >&2
+    exit 1
+fi